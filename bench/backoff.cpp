@@ -0,0 +1,61 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <Backoff.hpp>
+#include <MPMCQueue.hpp>
+#include <cstdint>
+
+using namespace mpmc_queue;
+
+namespace {
+
+constexpr size_t kQueueCapacity = 4096;
+
+template <typename Backoff>
+using Queue = MPMCQueue<uint64_t, kQueueCapacity, PackedLayout<>, Backoff>;
+
+Queue<NoBackoff> g_no_backoff_queue;
+Queue<PauseBackoff<>> g_pause_queue;
+Queue<ExponentialBackoff<>> g_exponential_queue;
+Queue<SpinThenYieldBackoff<>> g_spin_yield_queue;
+
+// Every thread pushes and pops back to back, so all threads contend for
+// both indices all the time.
+template <typename Q>
+void PushPopPairs(benchmark::State& state, Q& queue) {
+  uint64_t value = 0;
+  for (auto _ : state) {
+    while (!queue.push(value)) {
+    }
+    while (!queue.pop(value)) {
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_NoBackoff(benchmark::State& state) {
+  PushPopPairs(state, g_no_backoff_queue);
+}
+
+void BM_PauseBackoff(benchmark::State& state) {
+  PushPopPairs(state, g_pause_queue);
+}
+
+void BM_ExponentialBackoff(benchmark::State& state) {
+  PushPopPairs(state, g_exponential_queue);
+}
+
+void BM_SpinThenYieldBackoff(benchmark::State& state) {
+  PushPopPairs(state, g_spin_yield_queue);
+}
+
+}  // namespace
+
+BENCHMARK(BM_NoBackoff)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK(BM_PauseBackoff)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK(BM_ExponentialBackoff)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK(BM_SpinThenYieldBackoff)->ThreadRange(1, 32)->UseRealTime();
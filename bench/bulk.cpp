@@ -0,0 +1,62 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <array>
+#include <cstdint>
+
+using namespace mpmc_queue;
+
+namespace {
+
+constexpr size_t kQueueCapacity = 4096;
+constexpr size_t kMaxBatch = 256;
+
+MPMCQueue<uint64_t, kQueueCapacity> g_queue;
+
+// Items/sec when every item pays its own CAS on head_ and tail_.
+void BM_SinglePushPop(benchmark::State& state) {
+  const auto batch = static_cast<size_t>(state.range(0));
+  uint64_t value = 0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < batch; ++i) {
+      while (!g_queue.push(i)) {
+      }
+    }
+    for (size_t i = 0; i < batch; ++i) {
+      while (!g_queue.pop(value)) {
+      }
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch));
+}
+
+// Items/sec when a whole batch shares one CAS on each index.
+void BM_BulkPushPop(benchmark::State& state) {
+  const auto batch = static_cast<size_t>(state.range(0));
+  std::array<uint64_t, kMaxBatch> in{};
+  std::array<uint64_t, kMaxBatch> out{};
+  for (auto _ : state) {
+    while (!g_queue.push_bulk(std::span<const uint64_t>(in.data(), batch))) {
+    }
+    while (!g_queue.pop_bulk(std::span<uint64_t>(out.data(), batch))) {
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch));
+}
+
+}  // namespace
+
+BENCHMARK(BM_SinglePushPop)
+    ->RangeMultiplier(4)
+    ->Range(1, kMaxBatch)
+    ->ThreadRange(1, 8);
+BENCHMARK(BM_BulkPushPop)
+    ->RangeMultiplier(4)
+    ->Range(1, kMaxBatch)
+    ->ThreadRange(1, 8);
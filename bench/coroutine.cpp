@@ -0,0 +1,96 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <ThreadPool.hpp>
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <thread>
+
+using namespace mpmc_queue;
+
+namespace {
+
+using Queue = MPMCQueue<int, 64>;
+
+struct DetachedTask {
+  struct promise_type {
+    auto get_return_object() noexcept -> DetachedTask { return {}; }
+    auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+    auto final_suspend() noexcept -> std::suspend_never { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+// Echoes requests back until the request queue is closed
+auto EchoCoroutine(Queue& requests, Queue& replies, ThreadPool& pool,
+                   std::atomic<bool>& done) -> DetachedTask {
+  int val;
+  while (co_await requests.async_pop(val, pool) == QueueStatus::kOk) {
+    (void)replies.push(val);
+  }
+  done.store(true, std::memory_order_release);
+}
+
+// Round trip through an echo that is a coroutine suspended in async_pop()
+// and resumed on a one-thread ThreadPool
+void BM_HandoffCoroutine(benchmark::State& state) {
+  Queue requests;
+  Queue replies;
+  std::atomic<bool> done{false};
+  {
+    ThreadPool pool(1);
+    pool.submit([&]() { EchoCoroutine(requests, replies, pool, done); });
+    int val = 0;
+    for (auto _ : state) {
+      (void)requests.push(val);
+      while (!replies.pop(val)) {
+        std::this_thread::yield();
+      }
+    }
+    requests.close();
+    while (!done.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// The same round trip through an echo thread that polls with pop() and
+// yields while the queue is empty
+void BM_HandoffSpinYieldThread(benchmark::State& state) {
+  Queue requests;
+  Queue replies;
+  std::thread echo([&]() {
+    int val;
+    for (;;) {
+      if (requests.pop(val)) {
+        (void)replies.push(val);
+      } else if (requests.is_closed()) {
+        break;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+  int val = 0;
+  for (auto _ : state) {
+    (void)requests.push(val);
+    while (!replies.pop(val)) {
+      std::this_thread::yield();
+    }
+  }
+  requests.close();
+  echo.join();
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(BM_HandoffCoroutine)->UseRealTime();
+BENCHMARK(BM_HandoffSpinYieldThread)->UseRealTime();
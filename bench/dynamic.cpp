@@ -0,0 +1,45 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <cstdint>
+
+using namespace mpmc_queue;
+
+namespace {
+
+constexpr size_t kQueueCapacity = 4096;
+
+MPMCQueue<uint64_t, kQueueCapacity> g_static_queue;
+MPMCQueue<uint64_t, kDynamicCapacity> g_dynamic_queue(kQueueCapacity);
+
+// Same push/pop-pair workload for both; the only difference is whether the
+// capacity is a compile-time constant or loaded from the queue.
+template <typename Queue>
+void PushPopPairs(benchmark::State& state, Queue& queue) {
+  uint64_t value = 0;
+  for (auto _ : state) {
+    while (!queue.push(value)) {
+    }
+    while (!queue.pop(value)) {
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_StaticCapacity(benchmark::State& state) {
+  PushPopPairs(state, g_static_queue);
+}
+
+void BM_DynamicCapacity(benchmark::State& state) {
+  PushPopPairs(state, g_dynamic_queue);
+}
+
+}  // namespace
+
+BENCHMARK(BM_StaticCapacity)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_DynamicCapacity)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,69 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+using namespace mpmc_queue;
+
+namespace {
+
+constexpr size_t kBatch = 64;
+
+// 256-byte message whose constructor writes every byte
+struct Payload {
+  uint64_t id = 0;
+  uint64_t tag = 0;
+  unsigned char body[240] = {};
+
+  Payload() = default;
+  Payload(uint64_t id_in, unsigned char fill) : id(id_in), tag(id_in ^ fill) {
+    std::memset(body, fill, sizeof(body));
+  }
+};
+
+static_assert(sizeof(Payload) == 256);
+
+using Queue = MPMCQueue<Payload, 1024>;
+
+// Builds each Payload on the caller's side, then moves it into the cell
+void BM_PushPayload256(benchmark::State& state) {
+  auto queue = std::make_unique<Queue>();
+  Payload out;
+  for (auto _ : state) {
+    for (size_t i = 0; i < kBatch; ++i) {
+      (void)queue->push(Payload(i, static_cast<unsigned char>(i)));
+    }
+    for (size_t i = 0; i < kBatch; ++i) {
+      (void)queue->pop(out);
+    }
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kBatch));
+}
+
+// Constructs each Payload directly in its cell
+void BM_EmplacePayload256(benchmark::State& state) {
+  auto queue = std::make_unique<Queue>();
+  Payload out;
+  for (auto _ : state) {
+    for (size_t i = 0; i < kBatch; ++i) {
+      (void)queue->emplace(i, static_cast<unsigned char>(i));
+    }
+    for (size_t i = 0; i < kBatch; ++i) {
+      (void)queue->pop(out);
+    }
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kBatch));
+}
+
+}  // namespace
+
+BENCHMARK(BM_PushPayload256);
+BENCHMARK(BM_EmplacePayload256);
@@ -0,0 +1,47 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <EventCount.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace mpmc_queue;
+
+namespace {
+
+// Cost of notify_one() seen by the notifier with state.range(0) threads
+// asleep on the same EventCount. Woken threads go straight back to sleep.
+void BM_NotifyOne(benchmark::State& state) {
+  EventCount ec;
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> waiters;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    waiters.emplace_back([&]() {
+      for (;;) {
+        auto key = ec.prepare_wait();
+        if (stop.load(std::memory_order_seq_cst)) {
+          ec.cancel_wait();
+          return;
+        }
+        ec.commit_wait(key);
+      }
+    });
+  }
+
+  for (auto _ : state) {
+    ec.notify_one();
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  stop.store(true, std::memory_order_seq_cst);
+  ec.notify_all();
+  for (auto& t : waiters) t.join();
+}
+
+}  // namespace
+
+BENCHMARK(BM_NotifyOne)->Arg(0)->Arg(1)->Arg(8)->UseRealTime();
@@ -0,0 +1,113 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <WorkStealingDeque.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace mpmc_queue;
+
+namespace {
+
+// Binary fork-join tree: a task of depth d > 0 spawns two tasks of depth
+// d - 1. Work ends when all 2^(kDepth + 1) - 1 tasks have run.
+constexpr uint32_t kDepth = 16;
+constexpr int64_t kTotalTasks = (int64_t{1} << (kDepth + 1)) - 1;
+
+// Every worker pushes and pops through one shared queue
+void RunGlobalQueue(int workers) {
+  auto queue = std::make_unique<MPMCQueue<uint32_t, 1 << 17>>();
+  std::atomic<int64_t> done{0};
+  (void)queue->push(kDepth);
+
+  std::vector<std::thread> threads;
+  for (int w = 0; w < workers; ++w) {
+    threads.emplace_back([&]() {
+      uint32_t depth;
+      while (done.load(std::memory_order_relaxed) < kTotalTasks) {
+        if (!queue->pop(depth)) {
+          std::this_thread::yield();
+          continue;
+        }
+        if (depth > 0) {
+          (void)queue->push(depth - 1);
+          (void)queue->push(depth - 1);
+        }
+        done.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+}
+
+// Each worker owns a deque and steals from a random victim when it runs
+// dry
+void RunWorkStealing(int workers) {
+  using Deque = WorkStealingDeque<uint32_t, 1024>;
+  auto deques = std::make_unique<Deque[]>(static_cast<size_t>(workers));
+  std::atomic<int64_t> done{0};
+  (void)deques[0].push(kDepth);
+
+  std::vector<std::thread> threads;
+  for (int w = 0; w < workers; ++w) {
+    threads.emplace_back([&, w]() {
+      Deque& own = deques[static_cast<size_t>(w)];
+      uint32_t seed = static_cast<uint32_t>(w) * 2654435761u + 1;
+      uint32_t depth;
+      while (done.load(std::memory_order_relaxed) < kTotalTasks) {
+        if (!own.pop(depth)) {
+          seed = seed * 1664525u + 1013904223u;
+          const auto victim = static_cast<size_t>(seed >> 8) %
+                              static_cast<size_t>(workers);
+          if (!deques[victim].steal(depth)) {
+            std::this_thread::yield();
+            continue;
+          }
+        }
+        for (int child = 0; child < 2 && depth > 0; ++child) {
+          if (!own.push(depth - 1)) {
+            // Depth-first order keeps the deque short; should it ever
+            // fill up, drop the subtree and count it as done
+            done.fetch_add((int64_t{1} << depth) - 1,
+                           std::memory_order_relaxed);
+          }
+        }
+        done.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+}
+
+// state.range(0) is the number of worker threads
+void BM_ForkJoinGlobalQueue(benchmark::State& state) {
+  for (auto _ : state) {
+    RunGlobalQueue(static_cast<int>(state.range(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * kTotalTasks);
+}
+
+void BM_ForkJoinWorkStealing(benchmark::State& state) {
+  for (auto _ : state) {
+    RunWorkStealing(static_cast<int>(state.range(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * kTotalTasks);
+}
+
+}  // namespace
+
+BENCHMARK(BM_ForkJoinGlobalQueue)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime();
+BENCHMARK(BM_ForkJoinWorkStealing)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime();
@@ -0,0 +1,59 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <cstdint>
+
+using namespace mpmc_queue;
+
+namespace {
+
+constexpr size_t kQueueCapacity = 1024;
+
+MPMCQueue<uint64_t, kQueueCapacity, PackedLayout<>> g_packed_queue;
+MPMCQueue<uint64_t, kQueueCapacity, PaddedLayout<>> g_padded_queue;
+MPMCQueue<uint64_t, kQueueCapacity, PaddedLayout<128>> g_padded128_queue;
+// Same footprint as g_packed_queue
+MPMCQueue<uint64_t, kQueueCapacity, RemappedLayout<>> g_remapped_queue;
+
+// Each thread pushes then pops, so concurrent threads work on neighbouring
+// cells; with a packed layout those share cache lines, while the padded and
+// remapped layouts keep them apart.
+template <typename Queue>
+void PushPopPairs(benchmark::State& state, Queue& queue) {
+  uint64_t value = 0;
+  for (auto _ : state) {
+    while (!queue.push(value)) {
+    }
+    while (!queue.pop(value)) {
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_PackedLayout(benchmark::State& state) {
+  PushPopPairs(state, g_packed_queue);
+}
+
+void BM_PaddedLayout(benchmark::State& state) {
+  PushPopPairs(state, g_padded_queue);
+}
+
+void BM_PaddedLayout128(benchmark::State& state) {
+  PushPopPairs(state, g_padded128_queue);
+}
+
+void BM_RemappedLayout(benchmark::State& state) {
+  PushPopPairs(state, g_remapped_queue);
+}
+
+}  // namespace
+
+BENCHMARK(BM_PackedLayout)->Threads(8)->Threads(16)->UseRealTime();
+BENCHMARK(BM_PaddedLayout)->Threads(8)->Threads(16)->UseRealTime();
+BENCHMARK(BM_PaddedLayout128)->Threads(8)->Threads(16)->UseRealTime();
+BENCHMARK(BM_RemappedLayout)->Threads(8)->Threads(16)->UseRealTime();
@@ -0,0 +1,88 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <cstdint>
+
+using namespace mpmc_queue;
+
+namespace {
+
+// A power of two and the non-power-of-two capacity it would replace
+constexpr size_t kPow2Capacity = 4096;
+constexpr size_t kOddCapacity = 3000;
+
+MPMCQueue<uint64_t, kPow2Capacity> g_static_pow2_queue;
+MPMCQueue<uint64_t, kOddCapacity> g_static_odd_queue;
+MPMCQueue<uint64_t, kDynamicCapacity> g_dynamic_pow2_queue(kPow2Capacity);
+MPMCQueue<uint64_t, kDynamicCapacity> g_dynamic_odd_queue(kOddCapacity);
+
+template <typename Queue>
+void PushPop(benchmark::State& state, Queue& queue) {
+  uint64_t value = 0;
+  for (auto _ : state) {
+    while (!queue.push(value)) {
+    }
+    while (!queue.pop(value)) {
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_PushPop_StaticMask(benchmark::State& state) {
+  PushPop(state, g_static_pow2_queue);
+}
+
+void BM_PushPop_StaticModulo(benchmark::State& state) {
+  PushPop(state, g_static_odd_queue);
+}
+
+void BM_PushPop_DynamicMask(benchmark::State& state) {
+  PushPop(state, g_dynamic_pow2_queue);
+}
+
+void BM_PushPop_DynamicFastModulo(benchmark::State& state) {
+  PushPop(state, g_dynamic_odd_queue);
+}
+
+// Index computation alone: mask vs Lemire reduction vs hardware division
+void BM_Index_Mask(benchmark::State& state) {
+  size_t mask = kPow2Capacity - 1;
+  benchmark::DoNotOptimize(mask);
+  size_t pos = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(pos++ & mask);
+  }
+}
+
+void BM_Index_FastModulo(benchmark::State& state) {
+  detail::FastModulo modulo(kOddCapacity);
+  benchmark::DoNotOptimize(modulo);
+  size_t pos = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(modulo(pos++));
+  }
+}
+
+void BM_Index_Divide(benchmark::State& state) {
+  size_t divisor = kOddCapacity;
+  benchmark::DoNotOptimize(divisor);
+  size_t pos = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(pos++ % divisor);
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_PushPop_StaticMask);
+BENCHMARK(BM_PushPop_StaticModulo);
+BENCHMARK(BM_PushPop_DynamicMask);
+BENCHMARK(BM_PushPop_DynamicFastModulo);
+BENCHMARK(BM_Index_Mask);
+BENCHMARK(BM_Index_FastModulo);
+BENCHMARK(BM_Index_Divide);
@@ -0,0 +1,63 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <MPSCQueue.hpp>
+#include <cstdint>
+
+using namespace mpmc_queue;
+
+namespace {
+
+constexpr size_t kQueueCapacity = 4096;
+
+MPMCQueue<uint64_t, kQueueCapacity> g_mpmc_queue;
+MPSCQueue<uint64_t, kQueueCapacity> g_mpsc_queue;
+
+// Thread 0 is the only consumer and drains one item per producer per
+// iteration; every other thread pushes one item per iteration.
+template <typename Queue>
+void ManyToOne(benchmark::State& state, Queue& queue) {
+  const auto producers = static_cast<size_t>(state.threads() - 1);
+  uint64_t value = 0;
+  if (state.thread_index() == 0) {
+    for (auto _ : state) {
+      for (size_t i = 0; i < producers; ++i) {
+        while (!queue.pop(value)) {
+        }
+      }
+      benchmark::DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<int64_t>(producers));
+  } else {
+    for (auto _ : state) {
+      while (!queue.push(value)) {
+      }
+      ++value;
+    }
+  }
+}
+
+void BM_ManyToOne_MPMC(benchmark::State& state) {
+  ManyToOne(state, g_mpmc_queue);
+}
+
+void BM_ManyToOne_MPSC(benchmark::State& state) {
+  ManyToOne(state, g_mpsc_queue);
+}
+
+// 1, 2, 4, 8, 16 and 32 producers plus the consumer
+void ProducerCounts(benchmark::internal::Benchmark* bench) {
+  for (int producers = 1; producers <= 32; producers *= 2) {
+    bench->Threads(producers + 1);
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_ManyToOne_MPMC)->Apply(ProducerCounts)->UseRealTime();
+BENCHMARK(BM_ManyToOne_MPSC)->Apply(ProducerCounts)->UseRealTime();
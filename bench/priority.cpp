@@ -0,0 +1,108 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <PriorityMPMCQueue.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace mpmc_queue;
+
+namespace {
+
+constexpr size_t kQueueCapacity = 1024;
+constexpr int kBulkProducers = 2;
+
+auto NowNanoseconds() -> int64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Adapters so that one harness drives both queues. Bulk items are 0;
+// control items carry their send time.
+struct FifoQueue {
+  MPMCQueue<int64_t, kQueueCapacity> queue;
+
+  auto push_bulk() -> bool { return queue.push(0); }
+  auto push_control(int64_t sent_at) -> bool { return queue.push(sent_at); }
+  auto pop(int64_t& item) -> bool { return queue.pop(item); }
+};
+
+struct BandedQueue {
+  PriorityMPMCQueue<int64_t, kQueueCapacity, 2> queue;
+
+  auto push_bulk() -> bool { return queue.push(0, 0); }
+  auto push_control(int64_t sent_at) -> bool {
+    return queue.push(sent_at, 1);
+  }
+  auto pop(int64_t& item) -> bool { return queue.pop(item); }
+};
+
+// Bulk producers keep the queue saturated while one consumer drains it.
+// Each iteration sends one control item and waits for the consumer to see
+// it; the counter is the mean time from push to pop of control items.
+template <typename Queue>
+void ControlLatency(benchmark::State& state) {
+  Queue queue;
+  std::atomic<bool> stop{false};
+  std::atomic<int64_t> received{0};
+  std::atomic<int64_t> total_latency{0};
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kBulkProducers; ++i) {
+    threads.emplace_back([&]() {
+      while (!stop.load(std::memory_order_relaxed)) {
+        if (!queue.push_bulk()) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  threads.emplace_back([&]() {
+    int64_t item = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+      if (!queue.pop(item)) {
+        std::this_thread::yield();
+      } else if (item != 0) {
+        total_latency += NowNanoseconds() - item;
+        ++received;
+      }
+    }
+  });
+
+  int64_t sent = 0;
+  for (auto _ : state) {
+    while (!queue.push_control(NowNanoseconds())) {
+      std::this_thread::yield();
+    }
+    ++sent;
+    while (received.load() < sent) {
+      std::this_thread::yield();
+    }
+  }
+  stop = true;
+  for (auto& t : threads) t.join();
+
+  state.counters["control_latency_ns"] =
+      static_cast<double>(total_latency) / static_cast<double>(sent);
+}
+
+void BM_FifoControlLatency(benchmark::State& state) {
+  ControlLatency<FifoQueue>(state);
+}
+
+void BM_PriorityControlLatency(benchmark::State& state) {
+  ControlLatency<BandedQueue>(state);
+}
+
+}  // namespace
+
+BENCHMARK(BM_FifoControlLatency)->Iterations(500)->UseRealTime();
+BENCHMARK(BM_PriorityControlLatency)->Iterations(500)->UseRealTime();
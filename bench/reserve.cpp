@@ -0,0 +1,102 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+using namespace mpmc_queue;
+
+namespace {
+
+constexpr size_t kBatch = 64;
+
+// 1 KiB wire message
+struct Message {
+  uint64_t id;
+  uint64_t length;
+  unsigned char body[1008];
+};
+
+static_assert(sizeof(Message) == 1024);
+
+using Queue = MPMCQueue<Message, 1024>;
+
+// Stand-in for a serializer: writes every byte of the message
+void Encode(uint64_t id, Message& out) {
+  out.id = id;
+  out.length = sizeof(out.body);
+  std::memset(out.body, static_cast<unsigned char>(id), sizeof(out.body));
+}
+
+// Serializes into a scratch message, which push() then copies into the cell
+void BM_PushFromScratch1K(benchmark::State& state) {
+  auto queue = std::make_unique<Queue>();
+  Message scratch;
+  Message out;
+  for (auto _ : state) {
+    for (size_t i = 0; i < kBatch; ++i) {
+      Encode(i, scratch);
+      (void)queue->push(scratch);
+    }
+    for (size_t i = 0; i < kBatch; ++i) {
+      (void)queue->pop(out);
+    }
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kBatch));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(kBatch * sizeof(Message)));
+}
+
+// Serializes straight into a reserved cell
+void BM_Reserve1K(benchmark::State& state) {
+  auto queue = std::make_unique<Queue>();
+  Message out;
+  for (auto _ : state) {
+    for (size_t i = 0; i < kBatch; ++i) {
+      if (auto slot = queue->try_reserve()) {
+        Encode(i, slot.emplace());
+        slot.commit();
+      }
+    }
+    for (size_t i = 0; i < kBatch; ++i) {
+      (void)queue->pop(out);
+    }
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kBatch));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(kBatch * sizeof(Message)));
+}
+
+// Reserves the whole batch with one CAS and serializes into it
+void BM_ReserveRun1K(benchmark::State& state) {
+  auto queue = std::make_unique<Queue>();
+  Message out;
+  for (auto _ : state) {
+    if (auto run = queue->try_reserve(kBatch)) {
+      for (size_t i = 0; i < kBatch; ++i) {
+        Encode(i, run.emplace());
+      }
+      run.commit();
+    }
+    for (size_t i = 0; i < kBatch; ++i) {
+      (void)queue->pop(out);
+    }
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kBatch));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(kBatch * sizeof(Message)));
+}
+
+}  // namespace
+
+BENCHMARK(BM_PushFromScratch1K);
+BENCHMARK(BM_Reserve1K);
+BENCHMARK(BM_ReserveRun1K);
@@ -0,0 +1,47 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <SCQueue.hpp>
+#include <cstdint>
+
+using namespace mpmc_queue;
+
+namespace {
+
+constexpr size_t kQueueCapacity = 4096;
+
+MPMCQueue<uint64_t, kQueueCapacity> g_mpmc_queue;
+SCQueue<uint64_t, kQueueCapacity> g_scq_queue;
+
+// Every thread pushes then pops one item per iteration, so all threads hit
+// both head and tail and the queue never holds more than one item per
+// thread.
+template <typename Queue>
+void PushPopPairs(benchmark::State& state, Queue& queue) {
+  uint64_t value = 0;
+  for (auto _ : state) {
+    while (!queue.push(value)) {
+    }
+    while (!queue.pop(value)) {
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_PushPopPairs_MPMC(benchmark::State& state) {
+  PushPopPairs(state, g_mpmc_queue);
+}
+
+void BM_PushPopPairs_SCQ(benchmark::State& state) {
+  PushPopPairs(state, g_scq_queue);
+}
+
+}  // namespace
+
+BENCHMARK(BM_PushPopPairs_MPMC)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_PushPopPairs_SCQ)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,55 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <Sender.hpp>
+#include <ThreadPool.hpp>
+#include <atomic>
+#include <thread>
+
+using namespace mpmc_queue;
+
+namespace {
+
+using Queue = MPMCQueue<int, 64>;
+
+struct FlagReceiver {
+  std::atomic<bool>* done;
+
+  void set_value() noexcept { done->store(true, std::memory_order_release); }
+  void set_stopped() noexcept { done->store(true, std::memory_order_release); }
+};
+
+// End-to-end latency of pop_sender | then | push_sender: the calling
+// thread starts the pipeline, which waits on the empty input queue, then
+// pushes an item and spins until the result arrives in the output queue.
+// The pipeline completes on a one-thread ThreadPool.
+void BM_SenderPipeline(benchmark::State& state) {
+  Queue in;
+  Queue out;
+  ThreadPool pool(1);
+  int val = 0;
+  for (auto _ : state) {
+    std::atomic<bool> done{false};
+    auto op = (pop_sender(in, pool) | then([](int v) { return v + 1; }) |
+               push_sender(out, pool))
+                  .connect(FlagReceiver{&done});
+    op.start();
+    (void)in.push(val);
+    while (!out.pop(val)) {
+      std::this_thread::yield();
+    }
+    // The operation state must outlive its completion
+    while (!done.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(BM_SenderPipeline)->UseRealTime();
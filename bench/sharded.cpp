@@ -0,0 +1,49 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <ShardedMPMCQueue.hpp>
+#include <cstdint>
+
+using namespace mpmc_queue;
+
+namespace {
+
+// Same total capacity for both
+MPMCQueue<uint64_t, 8192> g_single_queue;
+ShardedMPMCQueue<uint64_t, 1024, 8> g_sharded8_queue;
+ShardedMPMCQueue<uint64_t, 512, 16> g_sharded16_queue;
+
+template <typename Queue>
+void PushPopPairs(benchmark::State& state, Queue& queue) {
+  uint64_t value = 0;
+  for (auto _ : state) {
+    while (!queue.push(value)) {
+    }
+    while (!queue.pop(value)) {
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_SingleQueue(benchmark::State& state) {
+  PushPopPairs(state, g_single_queue);
+}
+
+void BM_Sharded8(benchmark::State& state) {
+  PushPopPairs(state, g_sharded8_queue);
+}
+
+void BM_Sharded16(benchmark::State& state) {
+  PushPopPairs(state, g_sharded16_queue);
+}
+
+}  // namespace
+
+BENCHMARK(BM_SingleQueue)->ThreadRange(8, 64)->UseRealTime();
+BENCHMARK(BM_Sharded8)->ThreadRange(8, 64)->UseRealTime();
+BENCHMARK(BM_Sharded16)->ThreadRange(8, 64)->UseRealTime();
@@ -0,0 +1,91 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <SPMCQueue.hpp>
+#include <cstdint>
+
+using namespace mpmc_queue;
+
+namespace {
+
+constexpr size_t kQueueCapacity = 4096;
+
+MPMCQueue<uint64_t, kQueueCapacity> g_mpmc_queue;
+SPMCQueue<uint64_t, kQueueCapacity> g_spmc_queue;
+
+// Producer-side cost with no consumers running: fill the ring, then drain
+// it outside the timed region.
+template <typename Queue>
+void ProducerOnly(benchmark::State& state, Queue& queue) {
+  uint64_t value = 0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < kQueueCapacity; ++i) {
+      benchmark::DoNotOptimize(queue.push(i));
+    }
+    state.PauseTiming();
+    while (queue.pop(value)) {
+    }
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(kQueueCapacity));
+}
+
+// Thread 0 is the only producer and pushes one item per consumer per
+// iteration; every other thread pops one item per iteration.
+template <typename Queue>
+void OneToMany(benchmark::State& state, Queue& queue) {
+  const auto consumers = static_cast<size_t>(state.threads() - 1);
+  uint64_t value = 0;
+  if (state.thread_index() == 0) {
+    for (auto _ : state) {
+      for (size_t i = 0; i < consumers; ++i) {
+        while (!queue.push(value)) {
+        }
+        ++value;
+      }
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<int64_t>(consumers));
+  } else {
+    for (auto _ : state) {
+      while (!queue.pop(value)) {
+      }
+      benchmark::DoNotOptimize(value);
+    }
+  }
+}
+
+void BM_ProducerOnly_MPMC(benchmark::State& state) {
+  ProducerOnly(state, g_mpmc_queue);
+}
+
+void BM_ProducerOnly_SPMC(benchmark::State& state) {
+  ProducerOnly(state, g_spmc_queue);
+}
+
+void BM_OneToMany_MPMC(benchmark::State& state) {
+  OneToMany(state, g_mpmc_queue);
+}
+
+void BM_OneToMany_SPMC(benchmark::State& state) {
+  OneToMany(state, g_spmc_queue);
+}
+
+// One producer plus 1, 2, 4 and 8 consumers
+void ConsumerCounts(benchmark::internal::Benchmark* bench) {
+  for (int consumers = 1; consumers <= 8; consumers *= 2) {
+    bench->Threads(consumers + 1);
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_ProducerOnly_MPMC);
+BENCHMARK(BM_ProducerOnly_SPMC);
+BENCHMARK(BM_OneToMany_MPMC)->Apply(ConsumerCounts)->UseRealTime();
+BENCHMARK(BM_OneToMany_SPMC)->Apply(ConsumerCounts)->UseRealTime();
@@ -0,0 +1,52 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <SPSCQueue.hpp>
+#include <cstdint>
+
+using namespace mpmc_queue;
+
+namespace {
+
+constexpr size_t kQueueCapacity = 4096;
+
+MPMCQueue<uint64_t, kQueueCapacity> g_mpmc_queue;
+SPSCQueue<uint64_t, kQueueCapacity> g_spsc_queue;
+
+// Thread 0 produces and thread 1 consumes one item per iteration, so both
+// sides run the same number of iterations and always drain the queue.
+template <typename Queue>
+void OneToOne(benchmark::State& state, Queue& queue) {
+  uint64_t value = 0;
+  if (state.thread_index() == 0) {
+    for (auto _ : state) {
+      while (!queue.push(value)) {
+      }
+      ++value;
+    }
+  } else {
+    for (auto _ : state) {
+      while (!queue.pop(value)) {
+      }
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_OneToOne_MPMC(benchmark::State& state) {
+  OneToOne(state, g_mpmc_queue);
+}
+
+void BM_OneToOne_SPSC(benchmark::State& state) {
+  OneToOne(state, g_spsc_queue);
+}
+
+}  // namespace
+
+BENCHMARK(BM_OneToOne_MPMC)->Threads(2)->UseRealTime();
+BENCHMARK(BM_OneToOne_SPSC)->Threads(2)->UseRealTime();
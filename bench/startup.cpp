@@ -0,0 +1,63 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+
+using namespace mpmc_queue;
+
+namespace {
+
+constexpr size_t kCapacity = size_t{1} << 20;
+
+using BigQueue = MPMCQueue<uint64_t, kCapacity>;
+
+// Constant-initialized: all-zero cells are an empty queue, so this lives in
+// .bss and costs nothing at startup
+BigQueue g_static_queue;
+
+// Resident set size of the process in bytes (Linux; 0 elsewhere)
+auto ResidentBytes() -> double {
+  std::ifstream statm("/proc/self/statm");
+  double total_pages = 0;
+  double resident_pages = 0;
+  statm >> total_pages >> resident_pages;
+  return resident_pages * 4096;
+}
+
+// One lap through the static queue, the first time it is used. The RSS
+// growth shows that its pages were not resident before.
+void BM_StaticQueueFirstLap(benchmark::State& state) {
+  const double before = ResidentBytes();
+  for (auto _ : state) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < kCapacity; ++i) {
+      (void)g_static_queue.push(i);
+    }
+    for (size_t i = 0; i < kCapacity; ++i) {
+      (void)g_static_queue.pop(value);
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  state.counters["rss_growth_MiB"] = (ResidentBytes() - before) / (1 << 20);
+  state.counters["queue_MiB"] =
+      static_cast<double>(sizeof(BigQueue)) / (1 << 20);
+}
+
+// Construct and destroy a queue of the same size on the heap
+void BM_ConstructHeapQueue(benchmark::State& state) {
+  for (auto _ : state) {
+    auto queue = std::make_unique<BigQueue>();
+    benchmark::DoNotOptimize(queue.get());
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_StaticQueueFirstLap)->Iterations(1);
+BENCHMARK(BM_ConstructHeapQueue);
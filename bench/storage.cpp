@@ -0,0 +1,73 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace mpmc_queue;
+
+namespace {
+
+constexpr size_t kCapacity = 65536;
+
+// Owns heap memory: non-trivial to construct, move and destroy
+struct Heavy {
+  std::string name;
+  std::vector<uint32_t> values;
+};
+
+auto MakeHeavy(uint32_t seed) -> Heavy {
+  return Heavy{std::string(32, static_cast<char>('a' + seed % 26)),
+               std::vector<uint32_t>(8, seed)};
+}
+
+// Construct and destroy an empty queue. Cells are raw storage, so no T is
+// constructed or destroyed: only the sequence numbers are written, and a
+// heavy T costs more only because its cells are larger.
+template <typename T>
+void BM_ConstructQueue(benchmark::State& state) {
+  for (auto _ : state) {
+    auto queue = std::make_unique<MPMCQueue<T, kCapacity>>();
+    benchmark::DoNotOptimize(queue.get());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(kCapacity));
+}
+
+// push(T&&) / pop(T&) round trips of a heavy T
+void BM_HeavyPushPop(benchmark::State& state) {
+  auto queue = std::make_unique<MPMCQueue<Heavy, 1024>>();
+  Heavy item = MakeHeavy(1);
+  for (auto _ : state) {
+    (void)queue->push(std::move(item));
+    (void)queue->pop(item);
+    benchmark::DoNotOptimize(item.name.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// emplace() / try_pop() round trips: construct in the cell, move out once
+void BM_HeavyEmplaceTryPop(benchmark::State& state) {
+  auto queue = std::make_unique<MPMCQueue<Heavy, 1024>>();
+  std::optional<Heavy> item = MakeHeavy(1);
+  for (auto _ : state) {
+    (void)queue->emplace(std::move(*item));
+    item = queue->try_pop();
+    benchmark::DoNotOptimize(item->name.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_ConstructQueue, uint64_t);
+BENCHMARK_TEMPLATE(BM_ConstructQueue, Heavy);
+BENCHMARK(BM_HeavyPushPop);
+BENCHMARK(BM_HeavyEmplaceTryPop);
@@ -0,0 +1,68 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <ThreadPool.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+using namespace mpmc_queue;
+
+namespace {
+
+constexpr int64_t kBatch = 10000;
+
+// One outside thread submits a batch of empty-bodied tasks and waits until
+// they have all run; state.range(0) is the number of workers
+void BM_ThreadPoolSubmitThroughput(benchmark::State& state) {
+  ThreadPool pool(static_cast<size_t>(state.range(0)));
+  std::atomic<int64_t> done{0};
+  int64_t submitted = 0;
+  for (auto _ : state) {
+    for (int64_t i = 0; i < kBatch; ++i) {
+      pool.submit([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+    }
+    submitted += kBatch;
+    while (done.load(std::memory_order_acquire) != submitted) {
+      std::this_thread::yield();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kBatch);
+}
+
+// Time from submit() to the task starting, with the workers parked: the
+// wake-up path of an idle pool
+void BM_ThreadPoolSubmitLatency(benchmark::State& state) {
+  using Clock = std::chrono::steady_clock;
+  ThreadPool pool(static_cast<size_t>(state.range(0)));
+  std::atomic<int64_t> started{0};
+  for (auto _ : state) {
+    // Give the workers time to find no work and park
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    const auto submit_time = Clock::now();
+    pool.submit([&started]() {
+      started.store(Clock::now().time_since_epoch().count(),
+                    std::memory_order_release);
+    });
+    int64_t start_ticks;
+    while ((start_ticks = started.exchange(0, std::memory_order_acquire)) ==
+           0) {
+      std::this_thread::yield();
+    }
+    const auto elapsed =
+        Clock::duration(start_ticks) - submit_time.time_since_epoch();
+    state.SetIterationTime(std::chrono::duration<double>(elapsed).count());
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_ThreadPoolSubmitThroughput)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+BENCHMARK(BM_ThreadPoolSubmitLatency)->Arg(1)->Arg(4)->UseManualTime();
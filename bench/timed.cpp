@@ -0,0 +1,77 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+using namespace mpmc_queue;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+auto NowNanoseconds() -> int64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             Clock::now().time_since_epoch())
+      .count();
+}
+
+// Wake-up latency: the time from push() until a consumer parked in
+// pop_for() (or pop_wait()) returns with the item. Each item carries its
+// push timestamp; the consumer is given time to fall asleep first.
+template <bool Timed>
+void WakeLatency(benchmark::State& state) {
+  MPMCQueue<int64_t, 16> queue;
+  std::atomic<int64_t> total_latency{0};
+  std::atomic<int64_t> received{0};
+
+  std::thread consumer([&]() {
+    int64_t sent_at = 0;
+    for (;;) {
+      if constexpr (Timed) {
+        while (queue.pop_for(sent_at, std::chrono::seconds(1)) !=
+               QueueStatus::kOk) {
+        }
+      } else {
+        queue.pop_wait(sent_at);
+      }
+      if (sent_at < 0) {
+        return;
+      }
+      total_latency += NowNanoseconds() - sent_at;
+      ++received;
+    }
+  });
+
+  int64_t sent = 0;
+  for (auto _ : state) {
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    queue.push_wait(NowNanoseconds());
+    ++sent;
+    while (received.load() < sent) {
+      std::this_thread::yield();
+    }
+  }
+  queue.push_wait(-1);
+  consumer.join();
+
+  state.counters["wake_latency_ns"] =
+      static_cast<double>(total_latency) / static_cast<double>(sent);
+}
+
+void BM_PopForWakeLatency(benchmark::State& state) { WakeLatency<true>(state); }
+
+void BM_PopWaitWakeLatency(benchmark::State& state) {
+  WakeLatency<false>(state);
+}
+
+}  // namespace
+
+BENCHMARK(BM_PopForWakeLatency)->Iterations(2000)->UseRealTime();
+BENCHMARK(BM_PopWaitWakeLatency)->Iterations(2000)->UseRealTime();
@@ -0,0 +1,70 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <MPMCQueue.hpp>
+#include <UnboundedMPMCQueue.hpp>
+#include <cstdint>
+#include <thread>
+
+using namespace mpmc_queue;
+
+namespace {
+
+MPMCQueue<uint64_t, 1024> g_bounded_queue;
+UnboundedMPMCQueue<uint64_t, 1024> g_unbounded_queue;
+
+// Thread 0 pushes a burst of state.range(0) items as fast as it can while
+// thread 1 drains them. The bounded queue makes the producer wait for the
+// consumer once 1024 items are queued; the unbounded queue absorbs the
+// whole burst.
+void BM_Burst_Bounded(benchmark::State& state) {
+  const auto burst = static_cast<uint64_t>(state.range(0));
+  uint64_t value = 0;
+  for (auto _ : state) {
+    for (uint64_t i = 0; i < burst; ++i) {
+      if (state.thread_index() == 0) {
+        while (!g_bounded_queue.push(i)) {
+          std::this_thread::yield();
+        }
+      } else {
+        while (!g_bounded_queue.pop(value)) {
+        }
+      }
+    }
+  }
+  benchmark::DoNotOptimize(value);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Burst_Unbounded(benchmark::State& state) {
+  const auto burst = static_cast<uint64_t>(state.range(0));
+  uint64_t value = 0;
+  for (auto _ : state) {
+    for (uint64_t i = 0; i < burst; ++i) {
+      if (state.thread_index() == 0) {
+        g_unbounded_queue.push(i);
+      } else {
+        while (!g_unbounded_queue.pop(value)) {
+        }
+      }
+    }
+  }
+  benchmark::DoNotOptimize(value);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+BENCHMARK(BM_Burst_Bounded)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 16)
+    ->Threads(2)
+    ->UseRealTime();
+BENCHMARK(BM_Burst_Unbounded)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 16)
+    ->Threads(2)
+    ->UseRealTime();
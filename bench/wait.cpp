@@ -0,0 +1,110 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#include <benchmark/benchmark.h>
+#include <time.h>
+
+#include <MPMCQueue.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+using namespace mpmc_queue;
+
+namespace {
+
+constexpr size_t kQueueCapacity = 1024;
+
+MPMCQueue<uint64_t, kQueueCapacity> g_queue;
+
+auto ThreadCpuSeconds() -> double {
+  timespec ts{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<double>(ts.tv_sec) +
+         static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+// The pattern used throughout the code base before push_wait/pop_wait
+void SpinYieldPush(uint64_t value) {
+  while (!g_queue.push(value)) {
+    std::this_thread::yield();
+  }
+}
+
+void SpinYieldPop(uint64_t& value) {
+  while (!g_queue.pop(value)) {
+    std::this_thread::yield();
+  }
+}
+
+void BlockingPush(uint64_t value) { g_queue.push_wait(value); }
+
+void BlockingPop(uint64_t& value) { g_queue.pop_wait(value); }
+
+// Even threads produce and odd threads consume, the same number of items
+// each, so every push is matched by a pop.
+template <auto Push, auto Pop>
+void Throughput(benchmark::State& state) {
+  uint64_t value = 0;
+  const bool producer = state.thread_index() % 2 == 0;
+  for (auto _ : state) {
+    if (producer) {
+      Push(value);
+    } else {
+      Pop(value);
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// A consumer that is idle most of the time: one item arrives per
+// millisecond. Reports the CPU the consumer burns per wall-clock second.
+template <auto Pop>
+void IdleConsumer(benchmark::State& state) {
+  std::atomic<double> consumer_cpu{0};
+  std::thread consumer([&]() {
+    const double start = ThreadCpuSeconds();
+    uint64_t value = 1;
+    while (value != 0) {
+      Pop(value);
+    }
+    consumer_cpu = ThreadCpuSeconds() - start;
+  });
+
+  const auto start = std::chrono::steady_clock::now();
+  for (auto _ : state) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    BlockingPush(1);
+  }
+  BlockingPush(0);
+  consumer.join();
+  const std::chrono::duration<double> wall =
+      std::chrono::steady_clock::now() - start;
+  state.counters["consumer_cpu"] = consumer_cpu / wall.count();
+}
+
+void BM_SpinYieldThroughput(benchmark::State& state) {
+  Throughput<SpinYieldPush, SpinYieldPop>(state);
+}
+
+void BM_BlockingThroughput(benchmark::State& state) {
+  Throughput<BlockingPush, BlockingPop>(state);
+}
+
+void BM_SpinYieldIdleConsumer(benchmark::State& state) {
+  IdleConsumer<SpinYieldPop>(state);
+}
+
+void BM_BlockingIdleConsumer(benchmark::State& state) {
+  IdleConsumer<BlockingPop>(state);
+}
+
+}  // namespace
+
+BENCHMARK(BM_SpinYieldThroughput)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK(BM_BlockingThroughput)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK(BM_SpinYieldIdleConsumer)->Iterations(200)->UseRealTime();
+BENCHMARK(BM_BlockingIdleConsumer)->Iterations(200)->UseRealTime();
@@ -0,0 +1,74 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#ifndef MPMCQUEUE_INCLUDE_ASYMMETRICBARRIER_HPP_
+#define MPMCQUEUE_INCLUDE_ASYMMETRICBARRIER_HPP_
+
+#include <atomic>
+
+#if defined(__linux__) && __STDC_HOSTED__
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace mpmc_queue {
+
+namespace detail {
+
+// A seq_cst fence on both sides of a store-then-load handshake costs a
+// full fence on each side. When one side runs on every push and pop and
+// the other only on a slow path, the pair below moves the cost to the
+// slow side: AsymmetricLightBarrier() is only a compiler barrier, and
+// AsymmetricHeavyBarrier() makes every other thread of the process run a
+// full fence (the membarrier syscall, a few hundred ns). A light barrier
+// paired with a heavy one orders like two seq_cst fences. Where membarrier
+// is missing, both are seq_cst fences.
+
+#if defined(__linux__) && __STDC_HOSTED__ && defined(SYS_membarrier)
+/**
+ * @brief Whether this process may use the expedited private membarrier
+ *
+ * Registers on the first call, so that both barriers agree on the choice
+ * before either returns.
+ */
+inline auto MembarrierRegistered() noexcept -> bool {
+  static const bool registered =
+      syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0,
+              0) == 0;
+  return registered;
+}
+#else
+constexpr auto MembarrierRegistered() noexcept -> bool { return false; }
+#endif
+
+/**
+ * @brief The cheap side of an asymmetric store-then-load handshake
+ */
+inline void AsymmetricLightBarrier() noexcept {
+  if (MembarrierRegistered()) {
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+  } else {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
+/**
+ * @brief The expensive side of an asymmetric store-then-load handshake
+ */
+inline void AsymmetricHeavyBarrier() noexcept {
+#if defined(__linux__) && __STDC_HOSTED__ && defined(SYS_membarrier)
+  if (MembarrierRegistered()) {
+    syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+    return;
+  }
+#endif
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+}  // namespace detail
+
+}  // namespace mpmc_queue
+
+#endif  // MPMCQUEUE_INCLUDE_ASYMMETRICBARRIER_HPP_
@@ -0,0 +1,133 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#ifndef MPMCQUEUE_INCLUDE_ASYNCWAITER_HPP_
+#define MPMCQUEUE_INCLUDE_ASYNCWAITER_HPP_
+
+#include <atomic>
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+
+namespace mpmc_queue {
+
+namespace detail {
+
+/**
+ * @brief Intrusive node of an operation waiting for a queue to change
+ *
+ * Lives inside the waiting operation (an awaiter in a coroutine frame), so
+ * waiting allocates nothing.
+ */
+struct AsyncWaiter {
+  AsyncWaiter* next = nullptr;
+  // Retries the operation. On success (or when the queue is closed) it
+  // hands the operation to its continuation and returns true; the node
+  // must not be touched after that. Returns false if it still has to wait.
+  bool (*try_complete)(AsyncWaiter*) noexcept = nullptr;
+};
+
+/**
+ * @brief Lock-free stack of AsyncWaiter nodes
+ *
+ * Nodes are only ever removed all at once by take_all(), never one by
+ * one, so the stack has no ABA problem even though nodes are reused.
+ * Every operation is seq_cst: push() followed by a seq_cst re-check of the
+ * queue indices is the waiter's half of the same Dekker handshake that
+ * EventCount uses, and empty() is the publisher's.
+ */
+class AsyncWaiterStack {
+ public:
+  constexpr AsyncWaiterStack() noexcept = default;
+
+  AsyncWaiterStack(const AsyncWaiterStack&) = delete;
+  auto operator=(const AsyncWaiterStack&) -> AsyncWaiterStack& = delete;
+  AsyncWaiterStack(AsyncWaiterStack&&) = delete;
+  auto operator=(AsyncWaiterStack&&) -> AsyncWaiterStack& = delete;
+
+  /**
+   * @brief Push a chain of nodes linked through next
+   */
+  void push(AsyncWaiter* first) noexcept {
+    AsyncWaiter* last = first;
+    while (last->next != nullptr) {
+      last = last->next;
+    }
+    AsyncWaiter* head = head_.load(std::memory_order_relaxed);
+    do {
+      last->next = head;
+    } while (!head_.compare_exchange_weak(head, first,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed));
+  }
+
+  /**
+   * @brief Remove and return every node, newest first
+   */
+  [[nodiscard]] auto take_all() noexcept -> AsyncWaiter* {
+    return head_.exchange(nullptr, std::memory_order_seq_cst);
+  }
+
+  [[nodiscard]] auto empty() const noexcept -> bool {
+    return head_.load(std::memory_order_seq_cst) == nullptr;
+  }
+
+ private:
+  std::atomic<AsyncWaiter*> head_{nullptr};
+};
+
+}  // namespace detail
+
+/**
+ * @brief Work that lives in its submitter's memory rather than the
+ * executor's
+ *
+ * ex.submit(task) runs task.run() once, like submit(fn) runs fn(), but the
+ * executor neither copies nor frees the task, so submitting allocates
+ * nothing. The task must stay alive until run() is called. The senders in
+ * Sender.hpp embed one in their operation state.
+ */
+class ExecutorTask {
+ public:
+  virtual void run() noexcept = 0;
+
+ protected:
+  ExecutorTask() noexcept = default;
+  ExecutorTask(const ExecutorTask&) noexcept = default;
+  auto operator=(const ExecutorTask&) noexcept -> ExecutorTask& = default;
+  ~ExecutorTask() = default;
+};
+
+/**
+ * @brief Executor that runs what it is given at once, on the thread whose
+ * push or pop made the waiting operation ready
+ */
+struct InlineExecutor {
+  template <typename F>
+  void submit(F&& fn) const noexcept {
+    fn();
+  }
+
+  void submit(ExecutorTask& task) const noexcept { task.run(); }
+};
+
+#if defined(__cpp_impl_coroutine)
+/**
+ * @brief Something a suspended coroutine can be resumed on
+ *
+ * ex.submit(f) must arrange for f() to be called, on any thread, and must
+ * not throw. Coroutine awaiters pass a std::coroutine_handle<>; the
+ * senders in Sender.hpp pass an ExecutorTask&. ThreadPool and
+ * InlineExecutor accept both, and function objects too.
+ */
+template <typename E>
+concept Executor = requires(E& ex, std::coroutine_handle<> handle) {
+  ex.submit(handle);
+};
+#endif
+
+}  // namespace mpmc_queue
+
+#endif  // MPMCQUEUE_INCLUDE_ASYNCWAITER_HPP_
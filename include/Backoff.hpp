@@ -0,0 +1,134 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#ifndef MPMCQUEUE_INCLUDE_BACKOFF_HPP_
+#define MPMCQUEUE_INCLUDE_BACKOFF_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#if __STDC_HOSTED__
+#include <thread>
+#endif
+
+namespace mpmc_queue {
+
+namespace detail {
+
+/**
+ * @brief Tell the CPU that the caller is spinning
+ *
+ * x86 pause / ARM yield: frees pipeline resources for the sibling
+ * hyperthread and avoids the memory-order mis-speculation penalty when the
+ * awaited line changes. A no-op on other targets.
+ */
+inline void CpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+}  // namespace detail
+
+// Backoff policies decide what a queue operation does after losing a race
+// (a failed CAS, or a stale index) and between retries of a blocking call.
+// A policy object is created at the start of each operation and called
+// once per retry, so it can escalate within one operation.
+
+/**
+ * @brief Retry immediately
+ *
+ * Lowest latency with few threads; at high thread counts the retries keep
+ * the index cache line bouncing between cores.
+ */
+struct NoBackoff {
+  void operator()() noexcept {}
+};
+
+/**
+ * @brief Spin a fixed number of pause instructions before each retry
+ *
+ * @tparam Spins Pause instructions per retry
+ */
+template <size_t Spins = 1>
+struct PauseBackoff {
+  void operator()() noexcept {
+    for (size_t i = 0; i < Spins; ++i) {
+      detail::CpuRelax();
+    }
+  }
+};
+
+/**
+ * @brief Truncated exponential backoff with jitter
+ *
+ * The n-th retry pauses for a random number of iterations in
+ * [1, min(MinSpins * 2^n, MaxSpins)]. The randomness keeps threads that
+ * collided once from colliding again on the next retry.
+ *
+ * @tparam MinSpins Upper bound of the first wait
+ * @tparam MaxSpins Upper bound the waits stop growing at
+ */
+template <size_t MinSpins = 4, size_t MaxSpins = 1024>
+class ExponentialBackoff {
+  static_assert(MinSpins > 0 && MinSpins <= MaxSpins,
+                "Need 0 < MinSpins <= MaxSpins");
+
+ public:
+  ExponentialBackoff() noexcept
+      // The stack address differs between threads, which is all the seed
+      // needs to do
+      : state_(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(this) >> 4) |
+               1) {}
+
+  void operator()() noexcept {
+    // xorshift32
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    const size_t spins = 1 + state_ % limit_;
+    for (size_t i = 0; i < spins; ++i) {
+      detail::CpuRelax();
+    }
+    if (limit_ < MaxSpins) {
+      limit_ = limit_ * 2 < MaxSpins ? limit_ * 2 : MaxSpins;
+    }
+  }
+
+ private:
+  uint32_t state_;
+  size_t limit_ = MinSpins;
+};
+
+#if __STDC_HOSTED__
+/**
+ * @brief Pause for the first SpinLimit retries, then yield the CPU
+ *
+ * Suits oversubscribed machines, where the thread that has to make
+ * progress for the retry to succeed may not be running.
+ *
+ * @tparam SpinLimit Retries that spin before the first yield
+ */
+template <size_t SpinLimit = 16>
+class SpinThenYieldBackoff {
+ public:
+  void operator()() noexcept {
+    if (count_ < SpinLimit) {
+      ++count_;
+      detail::CpuRelax();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+ private:
+  size_t count_ = 0;
+};
+#endif
+
+}  // namespace mpmc_queue
+
+#endif  // MPMCQUEUE_INCLUDE_BACKOFF_HPP_
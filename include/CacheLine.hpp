@@ -0,0 +1,42 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#ifndef MPMCQUEUE_INCLUDE_CACHELINE_HPP_
+#define MPMCQUEUE_INCLUDE_CACHELINE_HPP_
+
+#include <cstddef>
+#include <new>
+
+namespace mpmc_queue {
+
+/**
+ * @brief Distance that keeps independently written fields off each other's
+ * cache lines
+ *
+ * Defaults to std::hardware_destructive_interference_size where the library
+ * provides it and to 64 otherwise. Define MPMC_QUEUE_CACHE_LINE_SIZE to
+ * override it, e.g. 128 on x86 where the adjacent-line prefetcher pulls in
+ * lines in pairs. The value feeds into the layout of every queue, so all
+ * translation units of a program must agree on it.
+ */
+#if defined(MPMC_QUEUE_CACHE_LINE_SIZE)
+inline constexpr size_t kCacheLineSize = MPMC_QUEUE_CACHE_LINE_SIZE;
+#elif defined(__cpp_lib_hardware_interference_size)
+// GCC warns that the value depends on -mtune; that is the point of using it
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+inline constexpr size_t kCacheLineSize =
+    std::hardware_destructive_interference_size;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+inline constexpr size_t kCacheLineSize = 64;
+#endif
+
+}  // namespace mpmc_queue
+
+#endif  // MPMCQUEUE_INCLUDE_CACHELINE_HPP_
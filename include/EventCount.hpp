@@ -0,0 +1,237 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#ifndef MPMCQUEUE_INCLUDE_EVENTCOUNT_HPP_
+#define MPMCQUEUE_INCLUDE_EVENTCOUNT_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <climits>
+#include <ctime>
+#else
+#include <thread>
+#endif
+
+#if defined(__cpp_lib_atomic_wait)
+
+namespace mpmc_queue {
+
+namespace detail {
+
+#if defined(__linux__)
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "futex needs std::atomic<uint32_t> to be a plain 32-bit word");
+
+/**
+ * @brief Sleep while word == expected, at most timeout (nullptr: forever)
+ *
+ * May return early: on a wake, a signal, or if word already differs.
+ */
+inline void FutexWait(std::atomic<uint32_t>& word, uint32_t expected,
+                      const timespec* timeout) noexcept {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE,
+          expected, timeout, nullptr, 0);
+}
+
+/**
+ * @brief Wake up to count threads sleeping in FutexWait() on word
+ */
+inline void FutexWake(std::atomic<uint32_t>& word, int count) noexcept {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE,
+          count, nullptr, nullptr, 0);
+}
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief Lets threads sleep until a lock-free condition may have changed
+ *
+ * A condition variable for lock-free data structures. Waiters follow a
+ * two-phase protocol:
+ *
+ * @code
+ * for (;;) {
+ *   if (try_pop(item)) break;
+ *   auto key = ec.prepare_wait();
+ *   if (try_pop(item)) { ec.cancel_wait(); break; }
+ *   ec.commit_wait(key);
+ * }
+ * @endcode
+ *
+ * and the notifier changes the condition and then calls notify_one() or
+ * notify_all(). A notify that happens after prepare_wait() makes the
+ * matching commit_wait() return, so a waiter cannot miss a wakeup between
+ * its last check and going to sleep.
+ *
+ * This guarantee needs a seq_cst operation on both sides. prepare_wait()
+ * provides the waiter's. The notifier must make the condition true with a
+ * seq_cst read-modify-write (or follow it with a seq_cst fence), and the
+ * waiter's re-check must read it with a seq_cst load. With nobody waiting,
+ * notify is a single load of the waiter count (a plain mov on x86), with
+ * no read-modify-write and no syscall.
+ *
+ * Sleepers wait for an epoch counter that each notify with waiters
+ * advances. On Linux they sleep on it with the futex syscall, which unlike
+ * std::atomic::wait accepts a timeout. Elsewhere they use
+ * std::atomic<uint32_t>::wait, and timed waits poll the epoch with short
+ * sleeps. A waiter that stays between prepare_wait() and commit_wait()
+ * while exactly 2^32 notifies happen can miss one.
+ */
+class EventCount {
+ public:
+  /**
+   * @brief Ticket returned by prepare_wait() and passed to commit_wait()
+   */
+  class Key {
+    friend class EventCount;
+
+    explicit constexpr Key(uint32_t epoch) noexcept : epoch_(epoch) {}
+
+    uint32_t epoch_;
+  };
+
+  constexpr EventCount() noexcept = default;
+
+  ~EventCount() noexcept = default;
+
+  EventCount(const EventCount&) = delete;
+  auto operator=(const EventCount&) -> EventCount& = delete;
+  EventCount(EventCount&&) = delete;
+  auto operator=(EventCount&&) -> EventCount& = delete;
+
+  /**
+   * @brief Announce the intent to sleep
+   *
+   * Must be followed by exactly one cancel_wait() or commit_wait(). The
+   * caller re-checks its condition between the two.
+   *
+   * @return Key Epoch to pass to commit_wait()
+   */
+  [[nodiscard]] auto prepare_wait() noexcept -> Key {
+    waiters_.fetch_add(1, std::memory_order_seq_cst);
+    return Key(epoch_.load(std::memory_order_seq_cst));
+  }
+
+  /**
+   * @brief Abandon a prepare_wait() because the condition became true
+   */
+  void cancel_wait() noexcept {
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Sleep until a notify that happened after prepare_wait()
+   *
+   * Returns at once if such a notify has already happened. May also return
+   * spuriously; callers re-check their condition in a loop.
+   *
+   * @param key The value returned by the matching prepare_wait()
+   */
+  void commit_wait(Key key) noexcept {
+#if defined(__linux__)
+    while (epoch_.load(std::memory_order_relaxed) == key.epoch_) {
+      detail::FutexWait(epoch_, key.epoch_, nullptr);
+    }
+#else
+    epoch_.wait(key.epoch_, std::memory_order_relaxed);
+#endif
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief commit_wait() that gives up at a deadline
+   *
+   * @param key The value returned by the matching prepare_wait()
+   * @param deadline Time point after which to stop waiting
+   * @return true if woken by a notify (or spuriously)
+   * @return false if the deadline passed first
+   */
+  template <typename Clock, typename Duration>
+  [[nodiscard]] auto commit_wait_until(
+      Key key,
+      const std::chrono::time_point<Clock, Duration>& deadline) noexcept
+      -> bool {
+    bool notified = true;
+    while (epoch_.load(std::memory_order_relaxed) == key.epoch_) {
+      const auto now = Clock::now();
+      if (now >= deadline) {
+        notified = false;
+        break;
+      }
+      // Clamp so that far-off deadlines (e.g. time_point::max()) cannot
+      // overflow the conversion; the loop sleeps again after a clamped wait.
+      auto remaining = std::chrono::nanoseconds(kMaxSleep);
+      if (deadline - now < kMaxSleep) {
+        remaining =
+            std::chrono::ceil<std::chrono::nanoseconds>(deadline - now);
+      }
+#if defined(__linux__)
+      timespec timeout{};
+      timeout.tv_sec = static_cast<time_t>(remaining.count() / 1000000000);
+      timeout.tv_nsec = static_cast<long>(remaining.count() % 1000000000);
+      detail::FutexWait(epoch_, key.epoch_, &timeout);
+#else
+      // std::atomic::wait has no timeout
+      constexpr std::chrono::microseconds kPollInterval(50);
+      std::this_thread::sleep_for(remaining < kPollInterval ? remaining
+                                                            : kPollInterval);
+#endif
+    }
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+    return notified;
+  }
+
+  /**
+   * @brief Wake one thread sleeping in commit_wait(), if any
+   */
+  void notify_one() noexcept {
+    if (waiters_.load(std::memory_order_seq_cst) != 0) {
+      epoch_.fetch_add(1, std::memory_order_seq_cst);
+#if defined(__linux__)
+      detail::FutexWake(epoch_, 1);
+#else
+      epoch_.notify_one();
+#endif
+    }
+  }
+
+  /**
+   * @brief Wake every thread sleeping in commit_wait()
+   */
+  void notify_all() noexcept {
+    if (waiters_.load(std::memory_order_seq_cst) != 0) {
+      epoch_.fetch_add(1, std::memory_order_seq_cst);
+#if defined(__linux__)
+      detail::FutexWake(epoch_, INT_MAX);
+#else
+      epoch_.notify_all();
+#endif
+    }
+  }
+
+ private:
+  // Longest single sleep in commit_wait_until()
+  static constexpr std::chrono::hours kMaxSleep{24};
+
+  // Threads between prepare_wait() and the end of commit_wait() or
+  // cancel_wait()
+  std::atomic<uint32_t> waiters_{0};
+  // Advanced by every notify that finds waiters; sleepers wait on it
+  std::atomic<uint32_t> epoch_{0};
+};
+
+}  // namespace mpmc_queue
+
+#endif  // defined(__cpp_lib_atomic_wait)
+
+#endif  // MPMCQUEUE_INCLUDE_EVENTCOUNT_HPP_
@@ -6,13 +6,321 @@
 #define MPMCQUEUE_INCLUDE_MPMCQUEUE_HPP_
 
 #include <atomic>
+#include <bit>
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <exception>
+#include <new>
+#include <span>
 #include <type_traits>
 #include <utility>
 
+#if __STDC_HOSTED__
+#include <memory_resource>
+#include <optional>
+#endif
+
+#include "AsymmetricBarrier.hpp"
+#include "AsyncWaiter.hpp"
+#include "Backoff.hpp"
+#include "CacheLine.hpp"
+
+#if defined(__cpp_lib_atomic_wait)
+#include <chrono>
+
+#include "EventCount.hpp"
+#endif
+
 namespace mpmc_queue {
 
+/**
+ * @brief Capacity argument that makes the queue size itself at construction
+ *
+ * Like std::dynamic_extent for std::span: MPMCQueue<T, kDynamicCapacity>
+ * takes its capacity and storage in the constructor instead of embedding
+ * the ring in the queue object.
+ */
+inline constexpr size_t kDynamicCapacity = static_cast<size_t>(-1);
+
+/**
+ * @brief Layout policy that packs cells back to back
+ *
+ * Uses the least memory: a cell is sizeof(std::atomic<size_t>) + sizeof(T)
+ * rounded up to alignment, so for small T several cells share a cache line
+ * and threads working on neighbouring positions false-share it.
+ *
+ * @tparam Separation Alignment of the head and tail indices and the ring
+ */
+template <size_t Separation = kCacheLineSize>
+struct PackedLayout {
+  static_assert((Separation & (Separation - 1)) == 0 && Separation != 0,
+                "Separation must be a power of 2");
+  static constexpr size_t kSeparation = Separation;
+  static constexpr size_t kCellAlignment = 1;
+  static constexpr bool kRemap = false;
+};
+
+/**
+ * @brief Layout policy that gives every cell its own cache line
+ *
+ * Removes false sharing between neighbouring cells at the cost of memory:
+ * each cell is rounded up to Separation bytes, so a queue of 1024 ints
+ * takes 64 KiB (or 128 KiB with Separation = 128) instead of 16 KiB. Worth
+ * it when many threads hit the queue at once and T is small.
+ *
+ * @tparam Separation Cell size and alignment, and the alignment of the
+ * head and tail indices
+ */
+template <size_t Separation = kCacheLineSize>
+struct PaddedLayout {
+  static_assert((Separation & (Separation - 1)) == 0 && Separation != 0,
+                "Separation must be a power of 2");
+  static constexpr size_t kSeparation = Separation;
+  static constexpr size_t kCellAlignment = Separation;
+  static constexpr bool kRemap = false;
+};
+
+/**
+ * @brief Layout policy that keeps cells packed but spreads consecutive
+ * positions across cache lines
+ *
+ * The ring is viewed as a matrix of L cells per line by N lines, and
+ * position i goes to line i % N, column i / N. Consecutive positions,
+ * which are usually being worked on by different threads at the same time,
+ * land on different lines while the array stays as dense as PackedLayout.
+ * The mapping is a shift, a mask and an or. A cell smaller than a line is
+ * padded to a power of two so that lines hold whole cells: 16-byte cells
+ * (an int or a pointer) stay packed, a 24-byte cell takes 32 bytes.
+ *
+ * Requires a fixed power-of-two capacity. With fewer than two lines' worth
+ * of cells there is nothing to spread and the mapping is the identity.
+ *
+ * @tparam Separation Line size used for the mapping, and the alignment of
+ * the head and tail indices and the ring
+ */
+template <size_t Separation = kCacheLineSize>
+struct RemappedLayout {
+  static_assert((Separation & (Separation - 1)) == 0 && Separation != 0,
+                "Separation must be a power of 2");
+  static constexpr size_t kSeparation = Separation;
+  static constexpr size_t kCellAlignment = 1;
+  static constexpr bool kRemap = true;
+};
+
+/**
+ * @brief Result of a blocking queue operation that can fail
+ */
+enum class QueueStatus {
+  /// The item was enqueued or dequeued
+  kOk,
+  /// The deadline passed first
+  kTimeout,
+  /// The queue was closed (and, for a pop, has been drained)
+  kClosed,
+};
+
+namespace detail {
+
+#ifdef __SIZEOF_INT128__
+__extension__ using Uint128 = unsigned __int128;
+
+/**
+ * @brief Remainder by a runtime divisor without a division instruction
+ *
+ * Lemire, Kaser and Kurz, "Faster Remainder by Direct Computation" (2019):
+ * with M = ceil(2^128 / d), a % d is the high 64 bits of the low 128 bits
+ * of M * a, multiplied by d. Exact for every 64-bit a and d.
+ */
+class FastModulo {
+ public:
+  constexpr explicit FastModulo(uint64_t divisor) noexcept
+      : multiplier_(~Uint128{0} / divisor + 1), divisor_(divisor) {}
+
+  [[nodiscard]] constexpr auto operator()(uint64_t value) const noexcept
+      -> uint64_t {
+    Uint128 low = multiplier_ * value;
+    Uint128 bottom = ((low & UINT64_MAX) * divisor_) >> 64;
+    Uint128 top = (low >> 64) * divisor_;
+    return static_cast<uint64_t>((bottom + top) >> 64);
+  }
+
+ private:
+  Uint128 multiplier_;
+  uint64_t divisor_;
+};
+#else
+/**
+ * @brief Remainder by a runtime divisor (no 128-bit multiply available)
+ */
+class FastModulo {
+ public:
+  constexpr explicit FastModulo(uint64_t divisor) noexcept
+      : divisor_(divisor) {}
+
+  [[nodiscard]] constexpr auto operator()(uint64_t value) const noexcept
+      -> uint64_t {
+    return value % divisor_;
+  }
+
+ private:
+  uint64_t divisor_;
+};
+#endif
+
+/**
+ * @brief Ring of cells embedded in the queue object
+ *
+ * The modulo by a constant compiles to a mask for powers of two and to a
+ * multiply-shift sequence otherwise.
+ */
+template <typename Cell, size_t Capacity, typename Layout>
+class RingStorage {
+ public:
+  [[nodiscard]] static constexpr auto capacity() noexcept -> size_t {
+    return Capacity;
+  }
+
+  /**
+   * @brief Get the ring index (0 to capacity - 1) of position pos
+   */
+  [[nodiscard]] static constexpr auto index(size_t pos) noexcept -> size_t {
+    return pos % Capacity;
+  }
+
+  /**
+   * @brief Get the cell that holds position pos
+   */
+  [[nodiscard]] constexpr auto cell(size_t pos) noexcept -> Cell& {
+    if constexpr (Layout::kRemap) {
+      const size_t i = index(pos);
+      return cells_[((i & (kLines - 1)) << kColumnBits) | (i >> kLineBits)];
+    } else {
+      return cells_[index(pos)];
+    }
+  }
+
+ private:
+  static constexpr auto Log2(size_t n) noexcept -> size_t {
+    size_t bits = 0;
+    while ((size_t{1} << (bits + 1)) <= n) ++bits;
+    return bits;
+  }
+
+  static_assert(!Layout::kRemap || (Capacity & (Capacity - 1)) == 0,
+                "RemappedLayout requires a power-of-two capacity");
+  static_assert(!Layout::kRemap || sizeof(Cell) >= Layout::kSeparation ||
+                    Layout::kSeparation % sizeof(Cell) == 0,
+                "RemappedLayout requires cells that divide the line");
+
+  // Cells per line (rounded down to a power of two, at most Capacity) and
+  // the number of lines they make up
+  static constexpr size_t kColumnBits =
+      Log2(sizeof(Cell) >= Layout::kSeparation
+               ? 1
+               : (Layout::kSeparation / sizeof(Cell) < Capacity
+                      ? Layout::kSeparation / sizeof(Cell)
+                      : Capacity));
+  static constexpr size_t kLineBits = Log2(Capacity) - kColumnBits;
+  static constexpr size_t kLines = size_t{1} << kLineBits;
+
+  Cell cells_[Capacity];
+};
+
+/**
+ * @brief Ring of cells in memory supplied by the caller or a memory resource
+ *
+ * The index parameters sit next to the cell pointer and are never written
+ * after construction, so the hot path loads them from a shared, read-only
+ * cache line. Power-of-two capacities use a mask, anything else a
+ * precomputed FastModulo; the branch between the two never changes
+ * direction and is predicted perfectly.
+ */
+template <typename Cell, typename Layout>
+class RingStorage<Cell, kDynamicCapacity, Layout> {
+  static_assert(!Layout::kRemap,
+                "RemappedLayout requires a fixed power-of-two capacity");
+
+ public:
+  constexpr explicit RingStorage(std::span<Cell> cells) noexcept
+      : cells_(cells.data()),
+        capacity_(checked_capacity(cells.size())),
+        mask_(capacity_ - 1),
+        modulo_(capacity_),
+        pow2_((capacity_ & mask_) == 0) {}
+
+#if __STDC_HOSTED__
+  RingStorage(size_t capacity, std::pmr::memory_resource* resource)
+      : cells_(static_cast<Cell*>(
+            resource->allocate(capacity * sizeof(Cell), alignof(Cell)))),
+        capacity_(checked_capacity(capacity)),
+        mask_(capacity - 1),
+        modulo_(capacity),
+        pow2_((capacity & mask_) == 0),
+        resource_(resource) {
+    for (size_t i = 0; i < capacity_; ++i) {
+      ::new (static_cast<void*>(cells_ + i)) Cell;
+    }
+  }
+#endif
+
+  ~RingStorage() noexcept {
+#if __STDC_HOSTED__
+    if (resource_ != nullptr) {
+      for (size_t i = 0; i < capacity_; ++i) {
+        cells_[i].~Cell();
+      }
+      resource_->deallocate(cells_, capacity_ * sizeof(Cell), alignof(Cell));
+    }
+#endif
+  }
+
+  RingStorage(const RingStorage&) = delete;
+  auto operator=(const RingStorage&) -> RingStorage& = delete;
+
+  [[nodiscard]] constexpr auto capacity() const noexcept -> size_t {
+    return capacity_;
+  }
+
+  /**
+   * @brief Get the ring index (0 to capacity - 1) of position pos
+   */
+  [[nodiscard]] constexpr auto index(size_t pos) const noexcept -> size_t {
+    return pow2_ ? pos & mask_ : modulo_(pos);
+  }
+
+  /**
+   * @brief Get the cell that holds position pos
+   */
+  [[nodiscard]] constexpr auto cell(size_t pos) noexcept -> Cell& {
+    return cells_[index(pos)];
+  }
+
+ private:
+  // Checked while initializing capacity_, before modulo_ divides by it.
+  // A zero capacity terminates in release builds too.
+  static constexpr auto checked_capacity(size_t capacity) noexcept
+      -> size_t {
+    assert(capacity > 0 && "Capacity must be greater than 0");
+    if (capacity == 0) {
+      std::terminate();
+    }
+    return capacity;
+  }
+
+  Cell* cells_;
+  size_t capacity_;
+  size_t mask_;
+  FastModulo modulo_;
+  bool pow2_;
+#if __STDC_HOSTED__
+  // Owner of cells_, or nullptr if the caller supplied the storage
+  std::pmr::memory_resource* resource_ = nullptr;
+#endif
+};
+
+}  // namespace detail
+
 /**
  * @brief Multi-Producer Multi-Consumer Lock-Free Queue
  *
@@ -21,34 +329,142 @@ namespace mpmc_queue {
  * environments as it doesn't use dynamic memory allocation, exceptions, or
  * other standard library facilities beyond atomics.
  *
+ * With Capacity == kDynamicCapacity the capacity is chosen at construction
+ * and the ring lives outside the queue object, either in caller-supplied
+ * storage (usable in freestanding environments) or in memory obtained from
+ * a std::pmr::memory_resource (hosted only). The algorithm is the same; the
+ * only difference on the hot path is that the index mask is loaded from the
+ * queue instead of being a compile-time constant.
+ *
+ * Cells are raw storage, so T needs no default constructor, constructing
+ * the queue constructs no T, and destroying it destroys only the items
+ * still queued. Items are constructed in place by push and destroyed by
+ * pop.
+ *
+ * Any capacity is supported. Powers of two map positions to cells with a
+ * mask; other capacities use a modulo. The modulo mapping is only
+ * continuous while the size_t position counters do not wrap, so on targets
+ * with a 32-bit size_t, queues that may see more than 2^32 operations
+ * should use a power-of-two capacity.
+ *
+ * The Layout policy decides how far apart the hot fields are: PackedLayout
+ * (the default) stores cells back to back, PaddedLayout puts each cell on
+ * its own cache line, and RemappedLayout keeps cells packed but maps
+ * consecutive positions to different lines. All of them separate head_,
+ * tail_ and the ring by Layout::kSeparation bytes.
+ *
  * @tparam T The type of elements stored in the queue
- * @tparam Capacity The maximum number of elements (must be power of 2)
+ * @tparam Capacity The maximum number of elements, or kDynamicCapacity
+ * @tparam Layout PackedLayout, PaddedLayout or RemappedLayout
+ * @tparam Backoff What to do after losing a race for a position (see
+ * Backoff.hpp)
  */
-template <typename T, size_t Capacity>
+template <typename T, size_t Capacity, typename Layout = PackedLayout<>,
+          typename Backoff = NoBackoff>
 class MPMCQueue {
-  static_assert((Capacity & (Capacity - 1)) == 0,
-                "Capacity must be a power of 2");
   static_assert(Capacity > 0, "Capacity must be greater than 0");
 
+  static constexpr size_t kSeparation = Layout::kSeparation;
+  static constexpr size_t kBaseAlignment =
+      Layout::kCellAlignment > alignof(T)
+          ? (Layout::kCellAlignment > alignof(std::atomic<size_t>)
+                 ? Layout::kCellAlignment
+                 : alignof(std::atomic<size_t>))
+          : (alignof(T) > alignof(std::atomic<size_t>)
+                 ? alignof(T)
+                 : alignof(std::atomic<size_t>));
+  static constexpr size_t kPackedCellSize =
+      (sizeof(std::atomic<size_t>) + sizeof(T) + kBaseAlignment - 1) /
+      kBaseAlignment * kBaseAlignment;
+  // RemappedLayout puts a whole number of cells on each line, so a cell
+  // smaller than a line is padded to a power of two that divides it
+  static constexpr size_t kCellAlignment =
+      Layout::kRemap && kPackedCellSize < kSeparation
+          ? std::bit_ceil(kPackedCellSize)
+          : kBaseAlignment;
+
+  // The item lives in a union: it is constructed by the push that fills
+  // the cell and destroyed by the pop that empties it, so empty cells hold
+  // no T at all. The empty member keeps the default constructor constexpr,
+  // so that a static queue is constant-initialized.
+  struct alignas(kCellAlignment) Cell {
+    union Slot {
+      constexpr Slot() noexcept : empty() {}
+      constexpr ~Slot()
+        requires std::is_trivially_destructible_v<T>
+      = default;
+      constexpr ~Slot() {}
+
+      char empty;
+      T item;
+    };
+
+    std::atomic<size_t> sequence;
+    Slot slot;
+
+    [[nodiscard]] auto storage() noexcept -> void* {
+      return static_cast<void*>(&slot);
+    }
+
+    [[nodiscard]] auto item() noexcept -> T& { return slot.item; }
+  };
+
  public:
   using value_type = T;
   using size_type = size_t;
   using reference = T&;
   using const_reference = const T&;
+  /// Ring element; storage for a kDynamicCapacity queue is an array of these
+  using cell_type = Cell;
 
   /**
    * @brief Construct a new MPMCQueue object
    */
-  constexpr MPMCQueue() noexcept : head_(0), tail_(0) {
-    for (size_t i = 0; i < Capacity; ++i) {
-      buffer_[i].sequence.store(i, std::memory_order_relaxed);
-    }
+  constexpr MPMCQueue() noexcept
+    requires(Capacity != kDynamicCapacity)
+      : head_(0), tail_(0) {}
+
+  /**
+   * @brief Construct a queue over caller-supplied storage
+   *
+   * The queue does not take ownership; the storage must outlive it.
+   *
+   * @param storage Cells for the ring; storage.size() is the capacity
+   */
+  constexpr explicit MPMCQueue(std::span<cell_type> storage) noexcept
+    requires(Capacity == kDynamicCapacity)
+      : head_(0), tail_(0), buffer_(storage) {
+    init_sequences();
   }
 
+#if __STDC_HOSTED__
+  /**
+   * @brief Construct a queue whose ring is allocated from a memory resource
+   *
+   * @param capacity The maximum number of elements
+   * @param resource Memory resource that provides and later frees the ring
+   */
+  explicit MPMCQueue(size_t capacity,
+                     std::pmr::memory_resource* resource =
+                         std::pmr::get_default_resource())
+    requires(Capacity == kDynamicCapacity)
+      : head_(0), tail_(0), buffer_(capacity, resource) {}
+#endif
+
   /**
-   * @brief Destroy the MPMCQueue object
+   * @brief Destroy the MPMCQueue object and the items still in it
    */
-  ~MPMCQueue() noexcept = default;
+  constexpr ~MPMCQueue() noexcept
+    requires std::is_trivially_destructible_v<T>
+  = default;
+
+  constexpr ~MPMCQueue() noexcept {
+    const size_t head = head_.load(std::memory_order_relaxed) & ~kClosedBit;
+    for (size_t pos = tail_.load(std::memory_order_relaxed); pos != head;
+         ++pos) {
+      buffer_.cell(pos).item().~T();
+    }
+  }
 
   MPMCQueue(const MPMCQueue&) = delete;
   auto operator=(const MPMCQueue&) -> MPMCQueue& = delete;
@@ -77,6 +493,29 @@ class MPMCQueue {
     return enqueue_impl(std::move(item));
   }
 
+  /**
+   * @brief Attempt to enqueue an item constructed in place from args
+   *
+   * The item is constructed directly in the claimed cell, so unlike
+   * push(T(args...)) no temporary is built and nothing is moved.
+   *
+   * @param args Constructor arguments for T
+   * @return true if the item was successfully enqueued
+   * @return false if the queue is full
+   */
+  template <typename... Args>
+    requires std::is_constructible_v<T, Args&&...>
+  [[nodiscard]] auto emplace(Args&&... args) noexcept -> bool {
+    const bool pushed = try_enqueue_with([&](void* storage) {
+      ::new (storage) T(std::forward<Args>(args)...);
+    });
+    if (!pushed) {
+      return false;
+    }
+    wake_consumers(false);
+    return true;
+  }
+
   /**
    * @brief Attempt to dequeue an item
    *
@@ -85,109 +524,1274 @@ class MPMCQueue {
    * @return false if the queue is empty
    */
   [[nodiscard]] auto pop(T& item) noexcept -> bool {
-    size_t pos;
-    Cell* cell;
-    size_t seq;
-
-    pos = tail_.load(std::memory_order_relaxed);
+    if (!try_dequeue(item)) {
+      return false;
+    }
+    wake_producers(false);
+    return true;
+  }
 
-    for (;;) {
-      cell = &buffer_[pos & (Capacity - 1)];
-      seq = cell->sequence.load(std::memory_order_acquire);
-      intptr_t diff =
-          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+#if __STDC_HOSTED__
+  /**
+   * @brief Attempt to dequeue an item, returning it by value
+   *
+   * Unlike pop() this needs no T to assign to, so it suits types that are
+   * move-only or not default-constructible.
+   *
+   * @return std::optional<T> The item, or std::nullopt if the queue is empty
+   */
+  [[nodiscard]] auto try_pop() noexcept -> std::optional<T> {
+    std::optional<T> result;
+    if (!try_dequeue_with(
+            [&](T& stored) { result.emplace(std::move(stored)); })) {
+      return std::nullopt;
+    }
+    wake_producers(false);
+    return result;
+  }
+#endif
 
-      if (diff == 0) {
-        if (tail_.compare_exchange_weak(pos, pos + 1,
-                                        std::memory_order_relaxed)) {
-          item = std::move(cell->data);
-          cell->sequence.store(pos + Capacity, std::memory_order_release);
-          return true;
-        }
-      } else if (diff < 0) {
-        return false;
-      } else {
-        pos = tail_.load(std::memory_order_relaxed);
-      }
+  /**
+   * @brief Attempt to enqueue a batch of items as one contiguous run
+   *
+   * All positions are claimed with a single CAS on the producer index, so a
+   * batch costs one contended read-modify-write instead of one per item.
+   * Either every item is enqueued or none is.
+   *
+   * @param items The items to enqueue
+   * @return true if all items were enqueued
+   * @return false if the queue does not have room for all of them
+   */
+  [[nodiscard]] auto push_bulk(std::span<const T> items) noexcept -> bool {
+    if (items.size() > buffer_.capacity()) {
+      return false;
     }
+    return push_run(items, items.size()) == items.size();
   }
 
   /**
-   * @brief Get the capacity of the queue
+   * @brief Enqueue as many items from the front of a batch as currently fit
    *
-   * @return constexpr size_t The maximum number of elements
+   * @param items The items to enqueue
+   * @return size_t Number of items enqueued, taken in order from the front
    */
-  [[nodiscard]] static constexpr auto max_size() noexcept -> size_t {
-    return Capacity;
+  [[nodiscard]] auto push_some(std::span<const T> items) noexcept -> size_t {
+    return push_run(items, 1);
   }
 
   /**
-   * @brief Get an approximate size of the queue
+   * @brief Attempt to dequeue exactly items.size() items
    *
-   * Note: This is an approximation and may not be accurate in concurrent
-   * scenarios.
+   * All positions are claimed with a single CAS on the consumer index.
+   * Either the whole span is filled or nothing is dequeued.
    *
-   * @return size_t Approximate number of elements in the queue
+   * @param items Storage for the dequeued items
+   * @return true if items.size() items were dequeued
+   * @return false if fewer items are available
    */
-  [[nodiscard]] auto size() const noexcept -> size_t {
-    size_t head = head_.load(std::memory_order_relaxed);
-    size_t tail = tail_.load(std::memory_order_relaxed);
-    return head >= tail ? head - tail : 0;
+  [[nodiscard]] auto pop_bulk(std::span<T> items) noexcept -> bool {
+    if (items.size() > buffer_.capacity()) {
+      return false;
+    }
+    return pop_run(items, items.size()) == items.size();
   }
 
   /**
-   * @brief Check if the queue is empty (approximate)
+   * @brief Dequeue up to items.size() items
    *
-   * Note: This is an approximation and may not be accurate in concurrent
-   * scenarios.
+   * @param items Storage for the dequeued items
+   * @return size_t Number of items dequeued into the front of the span
+   */
+  [[nodiscard]] auto pop_some(std::span<T> items) noexcept -> size_t {
+    return pop_run(items, 1);
+  }
+
+  /**
+   * @brief Cells claimed by try_reserve(), written in place, then published
+   * by commit()
    *
-   * @return true if the queue appears to be empty
-   * @return false if the queue appears to have elements
+   * Items are constructed one after another with emplace() directly in
+   * their cells, so a producer that serializes a message can write it
+   * where consumers will read it instead of into a scratch buffer that
+   * push() then copies. The cells are claimed as soon as the reservation
+   * is made: consumers wait at the first of them until commit(), so hold
+   * a reservation only for as long as it takes to fill it.
+   *
+   * A claimed cell cannot be handed back. Every reserved item must be
+   * constructed before commit(). A reservation destroyed without a
+   * commit(), e.g. by an early return or an exception, value-initializes
+   * the items not yet emplaced (T must then be default-constructible) and
+   * commits them all.
    */
-  [[nodiscard]] auto empty() const noexcept -> bool { return size() == 0; }
+  class Reservation {
+   public:
+    /**
+     * @brief An empty reservation, as returned when nothing could be claimed
+     */
+    Reservation() noexcept = default;
 
- private:
-  struct Cell {
-    std::atomic<size_t> sequence;
-    T data;
-  };
+    Reservation(Reservation&& other) noexcept
+        : queue_(std::exchange(other.queue_, nullptr)),
+          pos_(other.pos_),
+          count_(other.count_),
+          constructed_(other.constructed_) {}
 
-  template <typename U>
-  [[nodiscard]] auto enqueue_impl(U&& item) noexcept -> bool {
-    size_t pos;
-    Cell* cell;
-    size_t seq;
+    Reservation(const Reservation&) = delete;
+    auto operator=(const Reservation&) -> Reservation& = delete;
+    auto operator=(Reservation&&) -> Reservation& = delete;
 
-    pos = head_.load(std::memory_order_relaxed);
+    ~Reservation() noexcept {
+      if (queue_ == nullptr) {
+        return;
+      }
+      while (constructed_ < count_) {
+        emplace_value_initialized();
+      }
+      commit();
+    }
 
-    for (;;) {
-      cell = &buffer_[pos & (Capacity - 1)];
-      seq = cell->sequence.load(std::memory_order_acquire);
-      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+    /**
+     * @brief Whether cells were claimed and are not yet committed
+     */
+    [[nodiscard]] explicit operator bool() const noexcept {
+      return queue_ != nullptr;
+    }
 
-      if (diff == 0) {
-        if (head_.compare_exchange_weak(pos, pos + 1,
-                                        std::memory_order_relaxed)) {
-          cell->data = std::forward<U>(item);
-          cell->sequence.store(pos + 1, std::memory_order_release);
-          return true;
-        }
-      } else if (diff < 0) {
-        return false;
+    /**
+     * @brief Number of cells claimed
+     */
+    [[nodiscard]] auto size() const noexcept -> size_t { return count_; }
+
+    /**
+     * @brief Construct the next reserved item in its cell
+     *
+     * With no arguments the item is default-initialized, so a trivial T
+     * such as a byte array is left for the caller to fill in without
+     * being zeroed first. At most size() items can be emplaced; one more,
+     * or an emplace() on an empty reservation, terminates. If the
+     * constructor throws, the item does not count as emplaced.
+     *
+     * @param args Constructor arguments for T
+     * @return T& The new item, to be written before commit()
+     */
+    template <typename... Args>
+      requires std::is_constructible_v<T, Args&&...>
+    auto emplace(Args&&... args) -> T& {
+      assert(queue_ != nullptr && "emplace() on an empty reservation");
+      assert(constructed_ < count_ && "emplace() past the reserved cells");
+      if (queue_ == nullptr || constructed_ == count_) {
+        std::terminate();
+      }
+      void* storage = queue_->buffer_.cell(pos_ + constructed_).storage();
+      T* item;
+      if constexpr (sizeof...(Args) == 0) {
+        item = ::new (storage) T;
       } else {
-        pos = head_.load(std::memory_order_relaxed);
+        item = ::new (storage) T(std::forward<Args>(args)...);
+      }
+      ++constructed_;
+      return *item;
+    }
+
+    /**
+     * @brief The i-th reserved item, once emplace() has constructed it
+     */
+    [[nodiscard]] auto operator[](size_t i) noexcept -> T& {
+      assert(i < constructed_ && "item not emplaced");
+      return queue_->buffer_.cell(pos_ + i).item();
+    }
+
+    /**
+     * @brief Publish the reserved items to consumers
+     *
+     * Requires size() items to have been emplaced, and terminates
+     * otherwise, or if the reservation is empty: the cells would publish
+     * garbage. Leaves the reservation empty.
+     */
+    void commit() noexcept {
+      assert(queue_ != nullptr && "commit() on an empty reservation");
+      assert(constructed_ == count_ && "commit() before every emplace()");
+      if (queue_ == nullptr || constructed_ != count_) {
+        std::terminate();
       }
+      MPMCQueue& queue = *std::exchange(queue_, nullptr);
+      for (size_t i = 0; i < count_; ++i) {
+        queue.store_sequence(pos_ + i, queue.buffer_.cell(pos_ + i),
+                             pos_ + i + 1);
+      }
+      queue.wake_consumers(count_ > 1);
+    }
+
+   private:
+    friend class MPMCQueue;
+
+    Reservation(MPMCQueue& queue, size_t pos, size_t count) noexcept
+        : queue_(&queue), pos_(pos), count_(count) {}
+
+    void emplace_value_initialized() noexcept {
+      ::new (queue_->buffer_.cell(pos_ + constructed_).storage()) T();
+      ++constructed_;
+    }
+
+    MPMCQueue* queue_ = nullptr;
+    size_t pos_ = 0;
+    size_t count_ = 0;
+    size_t constructed_ = 0;
+  };
+
+  /**
+   * @brief Claim one cell to construct an item in place
+   *
+   * @code
+   * if (auto slot = queue.try_reserve()) {
+   *   encode(message, slot.emplace());
+   *   slot.commit();
+   * }
+   * @endcode
+   *
+   * @return Reservation The claimed cell, or an empty reservation if the
+   * queue is full or closed
+   */
+  [[nodiscard]] auto try_reserve() noexcept -> Reservation {
+    return try_reserve(1);
+  }
+
+  /**
+   * @brief Claim a contiguous run of count cells with a single CAS
+   *
+   * All or nothing, like push_bulk().
+   *
+   * @param count Number of cells to claim
+   * @return Reservation The claimed cells, or an empty reservation if the
+   * queue does not have room for all of them or is closed
+   */
+  [[nodiscard]] auto try_reserve(size_t count) noexcept -> Reservation {
+    // A dropped reservation fills its missing items with T()
+    static_assert(std::is_default_constructible_v<T>,
+                  "try_reserve() needs a default-constructible T");
+    size_t pos = 0;
+    if (count == 0 || count > buffer_.capacity() ||
+        claim_run(pos, count, count) == 0) {
+      return Reservation();
     }
+    return Reservation(*this, pos, count);
+  }
+
+#if defined(__cpp_lib_atomic_wait)
+  /**
+   * @brief Enqueue an item, sleeping while the queue is full
+   *
+   * Sleeps on an EventCount instead of spinning.
+   * Any pop (blocking or not) wakes a sleeping producer, so blocking and
+   * non-blocking calls can be mixed on the same queue.
+   *
+   * @param item The item to enqueue
+   * @return QueueStatus kOk, or kClosed if the queue is closed
+   */
+  auto push_wait(const T& item) noexcept -> QueueStatus {
+    return push_until(item, kForever);
+  }
+
+  /**
+   * @brief Enqueue an item, sleeping while the queue is full (move version)
+   *
+   * @param item The item to enqueue
+   * @return QueueStatus kOk, or kClosed if the queue is closed
+   */
+  auto push_wait(T&& item) noexcept -> QueueStatus {
+    return push_until(std::move(item), kForever);
   }
 
-  // Cache line padding to avoid false sharing
-  static constexpr size_t kCacheLineSize = 64;
+  /**
+   * @brief Dequeue an item, sleeping while the queue is empty
+   *
+   * Sleeps on an EventCount instead of spinning.
+   * Any push (blocking or not) wakes a sleeping consumer.
+   *
+   * @param item Reference to store the dequeued item
+   * @return QueueStatus kOk, or kClosed if the queue is closed and drained
+   */
+  auto pop_wait(T& item) noexcept -> QueueStatus {
+    return pop_until(item, kForever);
+  }
+
+  /**
+   * @brief Enqueue an item, waiting at most until a deadline for room
+   *
+   * Retries briefly, then sleeps until a consumer makes room or the
+   * deadline passes.
+   *
+   * @param item The item to enqueue; left untouched on timeout
+   * @param deadline Time point after which to give up
+   * @return QueueStatus kOk, kTimeout if the queue stayed full, or kClosed
+   */
+  template <typename U, typename Clock, typename Duration>
+    requires std::is_constructible_v<T, U&&>
+  [[nodiscard]] auto push_until(
+      U&& item,
+      const std::chrono::time_point<Clock, Duration>& deadline) noexcept
+      -> QueueStatus {
+    // enqueue_impl() only consumes item when it succeeds
+    Backoff backoff;
+    for (int i = 0; i < kSpinTries && !is_closed(); ++i) {
+      if (enqueue_impl(std::forward<U>(item))) {
+        return QueueStatus::kOk;
+      }
+      backoff();
+    }
+    while (!enqueue_impl(std::forward<U>(item))) {
+      const auto key = not_full_.prepare_wait();
+      const size_t tail = tail_.load(std::memory_order_seq_cst);
+      const size_t head = head_.load(std::memory_order_seq_cst);
+      if ((head & kClosedBit) != 0) {
+        not_full_.cancel_wait();
+        return QueueStatus::kClosed;
+      }
+      if (static_cast<intptr_t>(head - tail) <
+          static_cast<intptr_t>(buffer_.capacity())) {
+        // A consumer has claimed a position but may not have released it
+        // yet. After the barrier it either sees this sleeper or its
+        // release is visible to push_ready() (see serve_waiters()).
+        bool ready = push_ready();
+        if (!ready) {
+          detail::AsymmetricHeavyBarrier();
+          ready = push_ready();
+        }
+        if (ready) {
+          not_full_.cancel_wait();
+          continue;
+        }
+      }
+      if (!not_full_.commit_wait_until(key, deadline)) {
+        if (enqueue_impl(std::forward<U>(item))) {
+          return QueueStatus::kOk;
+        }
+        // The queue may have been closed after the wait gave up
+        return is_closed() ? QueueStatus::kClosed : QueueStatus::kTimeout;
+      }
+    }
+    return QueueStatus::kOk;
+  }
+
+  /**
+   * @brief Enqueue an item, waiting at most timeout for room
+   *
+   * @param item The item to enqueue; left untouched on timeout
+   * @param timeout How long to wait, measured on std::chrono::steady_clock
+   * @return QueueStatus kOk, kTimeout if the queue stayed full, or kClosed
+   */
+  template <typename U, typename Rep, typename Period>
+    requires std::is_constructible_v<T, U&&>
+  [[nodiscard]] auto push_for(
+      U&& item, const std::chrono::duration<Rep, Period>& timeout) noexcept
+      -> QueueStatus {
+    return push_until(std::forward<U>(item),
+                      std::chrono::steady_clock::now() + timeout);
+  }
+
+  /**
+   * @brief Dequeue an item, waiting at most until a deadline for one
+   *
+   * Retries briefly, then sleeps until a producer publishes an item or the
+   * deadline passes.
+   *
+   * @param item Reference to store the dequeued item
+   * @param deadline Time point after which to give up
+   * @return QueueStatus kOk, kTimeout if the queue stayed empty, or
+   * kClosed if it is closed and drained
+   */
+  template <typename Clock, typename Duration>
+  [[nodiscard]] auto pop_until(
+      T& item,
+      const std::chrono::time_point<Clock, Duration>& deadline) noexcept
+      -> QueueStatus {
+    Backoff backoff;
+    for (int i = 0; i < kSpinTries; ++i) {
+      if (pop(item)) {
+        return QueueStatus::kOk;
+      }
+      backoff();
+    }
+    while (!pop(item)) {
+      const auto key = not_empty_.prepare_wait();
+      const size_t head = head_.load(std::memory_order_seq_cst);
+      if ((head & ~kClosedBit) == tail_.load(std::memory_order_relaxed)) {
+        if ((head & kClosedBit) != 0) {
+          // Closed and drained: nothing will ever arrive
+          not_empty_.cancel_wait();
+          return QueueStatus::kClosed;
+        }
+      } else {
+        // A producer has claimed a position but may not have published
+        // it yet, possibly for as long as it holds a Reservation. After
+        // the barrier it either sees this sleeper or its publish is
+        // visible to pop_ready() (see serve_waiters()).
+        bool ready = pop_ready();
+        if (!ready) {
+          detail::AsymmetricHeavyBarrier();
+          ready = pop_ready();
+        }
+        if (ready) {
+          not_empty_.cancel_wait();
+          continue;
+        }
+      }
+      if (!not_empty_.commit_wait_until(key, deadline)) {
+        if (pop(item)) {
+          return QueueStatus::kOk;
+        }
+        // The queue may have been closed after the wait gave up
+        return closed_and_drained() ? QueueStatus::kClosed
+                                    : QueueStatus::kTimeout;
+      }
+    }
+    return QueueStatus::kOk;
+  }
+
+  /**
+   * @brief Dequeue an item, waiting at most timeout for one
+   *
+   * @param item Reference to store the dequeued item
+   * @param timeout How long to wait, measured on std::chrono::steady_clock
+   * @return QueueStatus kOk, kTimeout if the queue stayed empty, or
+   * kClosed if it is closed and drained
+   */
+  template <typename Rep, typename Period>
+  [[nodiscard]] auto pop_for(
+      T& item, const std::chrono::duration<Rep, Period>& timeout) noexcept
+      -> QueueStatus {
+    return pop_until(item, std::chrono::steady_clock::now() + timeout);
+  }
+#endif
+
+  /**
+   * @brief A pop that can wait for an item without blocking a thread
+   *
+   * The building block of async_pop() and of the senders in Sender.hpp.
+   * The wait state lives in this object, so waiting allocates nothing.
+   *
+   * @tparam Done Nullary noexcept callable run when a wait() completes
+   */
+  template <typename Done>
+  class PopOperation : detail::AsyncWaiter {
+   public:
+    PopOperation(MPMCQueue& queue, T& item, Done done) noexcept
+        : queue_(queue), item_(item), done_(std::move(done)) {}
+
+    PopOperation(const PopOperation&) = delete;
+    auto operator=(const PopOperation&) -> PopOperation& = delete;
+
+    /**
+     * @brief Complete the pop now if it can complete without waiting
+     *
+     * @return true if it completed; status() tells how
+     */
+    [[nodiscard]] auto try_now() noexcept -> bool {
+      if (queue_.pop(item_)) {
+        status_ = QueueStatus::kOk;
+        return true;
+      }
+      if (queue_.closed_and_drained()) {
+        status_ = QueueStatus::kClosed;
+        return true;
+      }
+      return false;
+    }
+
+    /**
+     * @brief Wait for an item or for the queue to be closed and drained
+     *
+     * The push or close() that makes the pop possible completes it and
+     * calls done() on its own thread, possibly before wait() returns.
+     * This object must stay alive until then.
+     */
+    void wait() noexcept {
+      next = nullptr;
+      try_complete = &TryComplete;
+      MPMCQueue& queue = queue_;
+      queue.async_consumers_.push(this);
+      // Covers pushes that finished before the registration
+      queue.serve_async_waiters();
+    }
+
+    /**
+     * @brief kOk, or kClosed if the queue is closed and drained
+     */
+    [[nodiscard]] auto status() const noexcept -> QueueStatus {
+      return status_;
+    }
+
+    [[nodiscard]] auto done() noexcept -> Done& { return done_; }
+
+   private:
+    static auto TryComplete(detail::AsyncWaiter* waiter) noexcept -> bool {
+      auto* self = static_cast<PopOperation*>(waiter);
+      if (self->queue_.try_dequeue(self->item_)) {
+        self->status_ = QueueStatus::kOk;
+      } else if (self->queue_.closed_and_drained()) {
+        self->status_ = QueueStatus::kClosed;
+      } else {
+        return false;
+      }
+      self->done_();
+      return true;
+    }
+
+    MPMCQueue& queue_;
+    T& item_;
+    Done done_;
+    QueueStatus status_ = QueueStatus::kOk;
+  };
+
+  /**
+   * @brief A push that can wait for room without blocking a thread
+   *
+   * Mirror of PopOperation.
+   *
+   * @tparam U Reference type the item is forwarded as
+   * @tparam Done Nullary noexcept callable run when a wait() completes
+   */
+  template <typename U, typename Done>
+  class PushOperation : detail::AsyncWaiter {
+   public:
+    PushOperation(MPMCQueue& queue, U&& item, Done done) noexcept
+        : queue_(queue), item_(std::forward<U>(item)), done_(std::move(done)) {}
+
+    PushOperation(const PushOperation&) = delete;
+    auto operator=(const PushOperation&) -> PushOperation& = delete;
+
+    /**
+     * @brief Complete the push now if it can complete without waiting
+     *
+     * @return true if it completed; status() tells how
+     */
+    [[nodiscard]] auto try_now() noexcept -> bool {
+      if (queue_.enqueue_impl(std::forward<U>(item_))) {
+        status_ = QueueStatus::kOk;
+        return true;
+      }
+      if (queue_.is_closed()) {
+        status_ = QueueStatus::kClosed;
+        return true;
+      }
+      return false;
+    }
+
+    /**
+     * @brief Wait for room or for the queue to be closed
+     *
+     * The pop or close() that makes the push possible completes it and
+     * calls done() on its own thread, possibly before wait() returns.
+     * This object and the item must stay alive until then.
+     */
+    void wait() noexcept {
+      next = nullptr;
+      try_complete = &TryComplete;
+      MPMCQueue& queue = queue_;
+      queue.async_producers_.push(this);
+      queue.serve_async_waiters();
+    }
+
+    /**
+     * @brief kOk, or kClosed if the queue is closed
+     */
+    [[nodiscard]] auto status() const noexcept -> QueueStatus {
+      return status_;
+    }
+
+    [[nodiscard]] auto done() noexcept -> Done& { return done_; }
+
+   private:
+    static auto TryComplete(detail::AsyncWaiter* waiter) noexcept -> bool {
+      auto* self = static_cast<PushOperation*>(waiter);
+      if (self->queue_.try_enqueue(std::forward<U>(self->item_))) {
+        self->status_ = QueueStatus::kOk;
+      } else if (self->queue_.is_closed()) {
+        self->status_ = QueueStatus::kClosed;
+      } else {
+        return false;
+      }
+      self->done_();
+      return true;
+    }
+
+    MPMCQueue& queue_;
+    U&& item_;
+    Done done_;
+    QueueStatus status_ = QueueStatus::kOk;
+  };
+
+#if defined(__cpp_impl_coroutine)
+  /**
+   * @brief Awaitable returned by async_pop()
+   */
+  template <Executor E>
+  class PopAwaiter {
+   public:
+    PopAwaiter(MPMCQueue& queue, T& item, E& executor) noexcept
+        : operation_(queue, item, Resume{&executor, {}}) {}
+
+    [[nodiscard]] auto await_ready() noexcept -> bool {
+      return operation_.try_now();
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) noexcept {
+      operation_.done().handle = handle;
+      operation_.wait();
+    }
+
+    [[nodiscard]] auto await_resume() const noexcept -> QueueStatus {
+      return operation_.status();
+    }
+
+   private:
+    struct Resume {
+      E* executor;
+      std::coroutine_handle<> handle;
+
+      void operator()() const noexcept { executor->submit(handle); }
+    };
+
+    PopOperation<Resume> operation_;
+  };
+
+  /**
+   * @brief Awaitable returned by async_push()
+   */
+  template <typename U, Executor E>
+  class PushAwaiter {
+   public:
+    PushAwaiter(MPMCQueue& queue, U&& item, E& executor) noexcept
+        : operation_(queue, std::forward<U>(item), Resume{&executor, {}}) {}
+
+    [[nodiscard]] auto await_ready() noexcept -> bool {
+      return operation_.try_now();
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) noexcept {
+      operation_.done().handle = handle;
+      operation_.wait();
+    }
+
+    [[nodiscard]] auto await_resume() const noexcept -> QueueStatus {
+      return operation_.status();
+    }
+
+   private:
+    struct Resume {
+      E* executor;
+      std::coroutine_handle<> handle;
+
+      void operator()() const noexcept { executor->submit(handle); }
+    };
+
+    PushOperation<U, Resume> operation_;
+  };
+
+  /**
+   * @brief Dequeue an item in a coroutine, suspending while the queue is
+   * empty
+   *
+   * @code
+   * T item;
+   * if (co_await queue.async_pop(item, executor) == QueueStatus::kOk) ...
+   * @endcode
+   *
+   * If an item is available the coroutine continues at once on its own
+   * thread. Otherwise it suspends without allocating (the wait state lives
+   * in the awaiter, inside the coroutine frame) and the push that makes an
+   * item available dequeues it on the coroutine's behalf and resumes the
+   * coroutine through executor.submit(). Any push wakes a suspended
+   * coroutine, so async and other calls can be mixed on the same queue.
+   * Suspended coroutines are not resumed in FIFO order.
+   *
+   * @param item Reference to store the dequeued item; must outlive the
+   * co_await
+   * @param executor Where to resume the coroutine (see Executor)
+   * @return Awaitable yielding QueueStatus kOk, or kClosed if the queue is
+   * closed and drained
+   */
+  template <Executor E>
+  [[nodiscard]] auto async_pop(T& item, E& executor) noexcept
+      -> PopAwaiter<E> {
+    return PopAwaiter<E>(*this, item, executor);
+  }
+
+  /**
+   * @brief Enqueue an item in a coroutine, suspending while the queue is
+   * full
+   *
+   * Mirror of async_pop(): the pop that makes room enqueues the item on
+   * the coroutine's behalf and resumes it through executor.submit().
+   *
+   * @param item The item to enqueue; consumed only when it is enqueued
+   * @param executor Where to resume the coroutine (see Executor)
+   * @return Awaitable yielding QueueStatus kOk, or kClosed if the queue is
+   * closed
+   */
+  template <typename U, Executor E>
+    requires std::is_constructible_v<T, U&&>
+  [[nodiscard]] auto async_push(U&& item, E& executor) noexcept
+      -> PushAwaiter<U, E> {
+    return PushAwaiter<U, E>(*this, std::forward<U>(item), executor);
+  }
+#endif
+
+  /**
+   * @brief Get the capacity of the queue
+   *
+   * @return constexpr size_t The maximum number of elements
+   */
+  [[nodiscard]] static constexpr auto max_size() noexcept -> size_t
+    requires(Capacity != kDynamicCapacity)
+  {
+    return Capacity;
+  }
+
+  /**
+   * @brief Get the capacity chosen at construction
+   *
+   * @return size_t The maximum number of elements
+   */
+  [[nodiscard]] constexpr auto max_size() const noexcept -> size_t
+    requires(Capacity == kDynamicCapacity)
+  {
+    return buffer_.capacity();
+  }
+
+  /**
+   * @brief Close the queue: no further pushes succeed
+   *
+   * Every push that has not succeeded by now fails (push() returns false,
+   * the blocking and timed variants return kClosed). Items already in the
+   * queue can still be popped; once it is drained, pop_wait() and the
+   * timed pops return kClosed. Wakes all threads blocked on the queue
+   * and resumes suspended async_pop()/async_push() coroutines the same
+   * way. Closing twice is harmless.
+   */
+  void close() noexcept {
+    head_.fetch_or(kClosedBit, std::memory_order_seq_cst);
+    wake_consumers(true);
+    wake_producers(true);
+  }
+
+  /**
+   * @brief Check whether close() has been called
+   */
+  [[nodiscard]] auto is_closed() const noexcept -> bool {
+    return (head_.load(std::memory_order_acquire) & kClosedBit) != 0;
+  }
+
+  /**
+   * @brief Get an approximate size of the queue
+   *
+   * Note: This is an approximation and may not be accurate in concurrent
+   * scenarios. The producer index is read with a seq_cst load, which
+   * PriorityMPMCQueue relies on when it re-checks a band after clearing the
+   * band's non-empty flag.
+   *
+   * @return size_t Approximate number of elements in the queue
+   */
+  [[nodiscard]] auto size() const noexcept -> size_t {
+    size_t head = head_.load(std::memory_order_seq_cst) & ~kClosedBit;
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    return head >= tail ? head - tail : 0;
+  }
+
+  /**
+   * @brief Check if the queue is empty (approximate)
+   *
+   * Note: This is an approximation and may not be accurate in concurrent
+   * scenarios.
+   *
+   * @return true if the queue appears to be empty
+   * @return false if the queue appears to have elements
+   */
+  [[nodiscard]] auto empty() const noexcept -> bool { return size() == 0; }
+
+ private:
+  constexpr void init_sequences() noexcept {
+    for (size_t i = 0; i < buffer_.capacity(); ++i) {
+      buffer_.cell(i).sequence.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // A cell stores its sequence number minus its ring index: the lap base
+  // (lap * capacity) while it is free and the lap base + 1 while it holds
+  // an item. Every cell of a zeroed ring is then free for lap 0, so a
+  // fixed-capacity queue needs no initialization loop and a static one
+  // lives in .bss, its pages faulted in only when first used.
+
+  /**
+   * @brief Load the sequence number of the cell at position pos
+   */
+  [[nodiscard]] auto load_sequence(size_t pos, Cell& cell) noexcept
+      -> size_t {
+    return cell.sequence.load(std::memory_order_acquire) +
+           buffer_.index(pos);
+  }
+
+  /**
+   * @brief Publish seq as the sequence number of the cell at position pos
+   */
+  void store_sequence(size_t pos, Cell& cell, size_t seq) noexcept {
+    cell.sequence.store(seq - buffer_.index(pos), std::memory_order_release);
+  }
+
+  template <typename U>
+  [[nodiscard]] auto enqueue_impl(U&& item) noexcept -> bool {
+    if (!try_enqueue(std::forward<U>(item))) {
+      return false;
+    }
+    wake_consumers(false);
+    return true;
+  }
+
+  /**
+   * @brief enqueue_impl() without waking anyone
+   */
+  template <typename U>
+  [[nodiscard]] auto try_enqueue(U&& item) noexcept -> bool {
+    return try_enqueue_with([&](void* storage) {
+      ::new (storage) T(std::forward<U>(item));
+    });
+  }
+
+  /**
+   * @brief Claim a cell, construct the item with write(cell storage), then
+   * publish it
+   */
+  template <typename Write>
+  [[nodiscard]] auto try_enqueue_with(Write&& write) noexcept -> bool {
+    size_t pos;
+    Cell* cell;
+    size_t seq;
+    Backoff backoff;
+
+    pos = head_.load(std::memory_order_relaxed);
+
+    for (;;) {
+      if ((pos & kClosedBit) != 0) {
+        return false;
+      }
+      cell = &buffer_.cell(pos);
+      seq = load_sequence(pos, *cell);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1, kClaimOrder,
+                                        std::memory_order_relaxed)) {
+          std::forward<Write>(write)(cell->storage());
+          store_sequence(pos, *cell, pos + 1);
+          return true;
+        }
+        backoff();
+      } else if (diff < 0) {
+        return false;
+      } else {
+        backoff();
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief pop() without waking anyone
+   */
+  [[nodiscard]] auto try_dequeue(T& item) noexcept -> bool {
+    return try_dequeue_with([&](T& stored) { item = std::move(stored); });
+  }
+
+  /**
+   * @brief Claim a published cell, hand its item to read(item), destroy
+   * the item and release the cell
+   */
+  template <typename Read>
+  [[nodiscard]] auto try_dequeue_with(Read&& read) noexcept -> bool {
+    size_t pos;
+    Cell* cell;
+    size_t seq;
+    Backoff backoff;
+
+    pos = tail_.load(std::memory_order_relaxed);
+
+    for (;;) {
+      cell = &buffer_.cell(pos);
+      seq = load_sequence(pos, *cell);
+      intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1, kClaimOrder,
+                                        std::memory_order_relaxed)) {
+          std::forward<Read>(read)(cell->item());
+          cell->item().~T();
+          store_sequence(pos, *cell, pos + buffer_.capacity());
+          return true;
+        }
+        backoff();
+      } else if (diff < 0) {
+        return false;
+      } else {
+        backoff();
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Wake consumers sleeping in pop_wait() after publishing items
+   *
+   * The seq_cst head_ CAS is the notifier's half of the EventCount
+   * handshake; pop_wait() re-checks head_ with a seq_cst load. With nobody
+   * asleep this is a single load, no syscall.
+   *
+   * The light barrier orders the publish before the look at the async
+   * waiters. It pairs with the heavy barrier in serve_waiters(): an async
+   * waiter that was put back on its stack after failing on this very cell
+   * is either seen here or sees the publish.
+   */
+  void wake_consumers([[maybe_unused]] bool all) noexcept {
+    detail::AsymmetricLightBarrier();
+#if defined(__cpp_lib_atomic_wait)
+    all ? not_empty_.notify_all() : not_empty_.notify_one();
+#endif
+    if (!async_consumers_.empty()) {
+      serve_async_waiters();
+    }
+  }
+
+  /**
+   * @brief Wake producers sleeping in push_wait() after releasing cells
+   *
+   * Mirror of wake_consumers() with the tail_ CAS.
+   */
+  void wake_producers([[maybe_unused]] bool all) noexcept {
+    detail::AsymmetricLightBarrier();
+#if defined(__cpp_lib_atomic_wait)
+    all ? not_full_.notify_all() : not_full_.notify_one();
+#endif
+    if (!async_producers_.empty()) {
+      serve_async_waiters();
+    }
+  }
+
+  /**
+   * @brief Complete suspended async_pop() and async_push() operations
+   *
+   * Completed pops make room for waiting pushes and the other way round,
+   * so both sides are served in turn until neither makes progress.
+   * Completions use try_dequeue()/try_enqueue() and only notify the
+   * EventCount sleepers themselves, which keeps this a loop rather than a
+   * recursion through wake_consumers()/wake_producers().
+   */
+  void serve_async_waiters() noexcept {
+    for (;;) {
+      const size_t popped = serve_waiters(
+          async_consumers_,
+          [this] {
+            const size_t head = head_.load(std::memory_order_seq_cst);
+            return (head & kClosedBit) != 0 ||
+                   head != tail_.load(std::memory_order_seq_cst);
+          },
+          [this] { return pop_ready(); });
+      const size_t pushed = serve_waiters(
+          async_producers_,
+          [this] {
+            const size_t tail = tail_.load(std::memory_order_seq_cst);
+            const size_t head = head_.load(std::memory_order_seq_cst);
+            return (head & kClosedBit) != 0 ||
+                   static_cast<intptr_t>(head - tail) <
+                       static_cast<intptr_t>(buffer_.capacity());
+          },
+          [this] { return push_ready(); });
+      if (popped == 0 && pushed == 0) {
+        return;
+      }
+      // The completions published or released cells; see wake_consumers()
+      detail::AsymmetricLightBarrier();
+#if defined(__cpp_lib_atomic_wait)
+      if (popped != 0) {
+        popped > 1 ? not_full_.notify_all() : not_full_.notify_one();
+      }
+      if (pushed != 0) {
+        pushed > 1 ? not_empty_.notify_all() : not_empty_.notify_one();
+      }
+#endif
+    }
+  }
+
+  /**
+   * @brief Retry the waiters on one stack until one of them fails
+   *
+   * The failed waiter and the ones behind it go back on the stack. A
+   * publish that looked at the stack while this held the waiters saw it
+   * empty, so before giving up this makes sure that the thread finishing
+   * the next cell will find them:
+   *
+   * - If the indices show no cell the waiters could use, later claims
+   *   come after the seq_cst push in the index handshake, and the
+   *   claiming thread looks at the stack after its claim.
+   * - If a cell was claimed, this tries again once the cell is published
+   *   or released. If it is still in flight, a heavy barrier pairs with
+   *   the light one in wake_consumers()/wake_producers(): either the
+   *   thread holding the cell sees the waiters, or a second look sees the
+   *   cell. Either way this never waits for another thread, which may be
+   *   this one holding a Reservation.
+   *
+   * @param possible Whether the indices leave a cell the waiters could use
+   * @param ready Whether that cell is published or released
+   * @return size_t Number of waiters completed
+   */
+  template <typename Possible, typename Ready>
+  auto serve_waiters(detail::AsyncWaiterStack& waiters, Possible possible,
+                     Ready ready) noexcept -> size_t {
+    size_t served = 0;
+    while (!waiters.empty()) {
+      detail::AsyncWaiter* waiter = waiters.take_all();
+      while (waiter != nullptr) {
+        // try_complete() may end the waiter's lifetime
+        detail::AsyncWaiter* next = waiter->next;
+        if (!waiter->try_complete(waiter)) {
+          break;
+        }
+        ++served;
+        waiter = next;
+      }
+      if (waiter == nullptr) {
+        continue;
+      }
+      waiters.push(waiter);
+      if (!possible()) {
+        break;
+      }
+      if (!ready()) {
+        detail::AsymmetricHeavyBarrier();
+        if (!ready()) {
+          break;
+        }
+      }
+    }
+    return served;
+  }
+
+  /**
+   * @brief Whether a pop would find a published item, or the queue closed
+   * and drained, without claiming anything
+   *
+   * A cell that is claimed but not yet published reads as not ready.
+   */
+  [[nodiscard]] auto pop_ready() noexcept -> bool {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      const size_t seq = load_sequence(pos, buffer_.cell(pos));
+      const intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        return true;
+      }
+      if (diff < 0) {
+        return closed_and_drained();
+      }
+      // Another consumer took this item; look at the new tail
+      pos = tail_.load(std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Whether a push would find a free cell, or the queue closed,
+   * without claiming anything
+   *
+   * A cell whose item is claimed but not yet released reads as not ready.
+   */
+  [[nodiscard]] auto push_ready() noexcept -> bool {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      if ((pos & kClosedBit) != 0) {
+        return true;
+      }
+      const size_t seq = load_sequence(pos, buffer_.cell(pos));
+      const intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        return true;
+      }
+      if (diff < 0) {
+        return false;
+      }
+      // Another producer claimed this cell; look at the new head
+      pos = head_.load(std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Check whether the queue is closed and holds no items
+   */
+  [[nodiscard]] auto closed_and_drained() const noexcept -> bool {
+    const size_t head = head_.load(std::memory_order_seq_cst);
+    return (head & kClosedBit) != 0 &&
+           (head & ~kClosedBit) == tail_.load(std::memory_order_seq_cst);
+  }
+
+  /**
+   * @brief Claim a run of at least min_count positions for producers
+   *
+   * The run is the longest prefix of free cells starting at head_, capped at
+   * max_count. A cell that is free for the current lap stays free until
+   * its position is claimed, so checking every cell before the CAS is enough
+   * to own the whole run once the CAS succeeds.
+   *
+   * @param pos Set to the first claimed position
+   * @return size_t Number of positions claimed (0 if fewer than min_count)
+   */
+  [[nodiscard]] auto claim_run(size_t& pos, size_t max_count,
+                               size_t min_count) noexcept -> size_t {
+    pos = head_.load(std::memory_order_relaxed);
+    Backoff backoff;
+
+    for (;;) {
+      if ((pos & kClosedBit) != 0) {
+        return 0;
+      }
+      size_t count = 0;
+      intptr_t diff = 0;
+      while (count < max_count) {
+        size_t seq = load_sequence(pos + count, buffer_.cell(pos + count));
+        diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + count);
+        if (diff != 0) {
+          break;
+        }
+        ++count;
+      }
+
+      if (diff > 0) {
+        backoff();
+        pos = head_.load(std::memory_order_relaxed);
+      } else if (count < min_count) {
+        return 0;
+      } else if (head_.compare_exchange_weak(pos, pos + count, kClaimOrder,
+                                             std::memory_order_relaxed)) {
+        return count;
+      } else {
+        backoff();
+      }
+    }
+  }
+
+  /**
+   * @brief Claim and fill a run of at least min_count positions
+   *
+   * @return size_t Number of items enqueued (0 if fewer than min_count fit)
+   */
+  [[nodiscard]] auto push_run(std::span<const T> items,
+                              size_t min_count) noexcept -> size_t {
+    if (items.empty()) {
+      return 0;
+    }
+    const size_t capacity = buffer_.capacity();
+    const size_t max_count = items.size() < capacity ? items.size() : capacity;
+    size_t pos;
+    const size_t count = claim_run(pos, max_count, min_count);
+    if (count == 0) {
+      return 0;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      Cell& cell = buffer_.cell(pos + i);
+      ::new (cell.storage()) T(items[i]);
+      store_sequence(pos + i, cell, pos + i + 1);
+    }
+    wake_consumers(count > 1);
+    return count;
+  }
+
+  /**
+   * @brief Claim and drain a run of at least min_count positions
+   *
+   * Mirror of claim_run() for consumers: the run is the longest prefix of
+   * published cells starting at tail_, capped at items.size().
+   *
+   * @return size_t Number of items dequeued (0 if fewer than min_count ready)
+   */
+  [[nodiscard]] auto pop_run(std::span<T> items, size_t min_count) noexcept
+      -> size_t {
+    if (items.empty()) {
+      return 0;
+    }
+    const size_t capacity = buffer_.capacity();
+    const size_t max_count = items.size() < capacity ? items.size() : capacity;
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    Backoff backoff;
+
+    for (;;) {
+      size_t count = 0;
+      intptr_t diff = 0;
+      while (count < max_count) {
+        size_t seq = load_sequence(pos + count, buffer_.cell(pos + count));
+        diff = static_cast<intptr_t>(seq) -
+               static_cast<intptr_t>(pos + count + 1);
+        if (diff != 0) {
+          break;
+        }
+        ++count;
+      }
+
+      if (diff > 0) {
+        backoff();
+        pos = tail_.load(std::memory_order_relaxed);
+      } else if (count < min_count) {
+        return 0;
+      } else if (tail_.compare_exchange_weak(pos, pos + count, kClaimOrder,
+                                             std::memory_order_relaxed)) {
+        for (size_t i = 0; i < count; ++i) {
+          Cell& cell = buffer_.cell(pos + i);
+          items[i] = std::move(cell.item());
+          cell.item().~T();
+          store_sequence(pos + i, cell, pos + i + capacity);
+        }
+        wake_producers(count > 1);
+        return count;
+      } else {
+        backoff();
+      }
+    }
+  }
+
+  // Order of the index CAS that claims positions. It is seq_cst because it
+  // is one half of Dekker-style handshakes with threads that check the
+  // indices before going to sleep (see EventCount) or before clearing a
+  // non-empty flag (see PriorityMPMCQueue); on x86 every CAS is a full
+  // barrier anyway.
+  static constexpr std::memory_order kClaimOrder = std::memory_order_seq_cst;
+
+#if defined(__cpp_lib_atomic_wait)
+  // Deadline of the untimed blocking calls
+  static constexpr auto kForever = std::chrono::steady_clock::time_point::max();
+  // pop()/push() attempts before a blocking call goes to sleep
+  static constexpr int kSpinTries = 64;
+#endif
+
+  // Set in head_ by close(). A push CAS expects head_ without it, so once
+  // it is set no push can succeed. Positions must stay below it: 2^63
+  // pushes on 64-bit targets, 2^31 on 32-bit ones.
+  static constexpr size_t kClosedBit = ~(~size_t{0} >> 1);
+
+  // Padding to avoid false sharing between the indices and the ring
+  alignas(kSeparation) std::atomic<size_t> head_;
+  alignas(kSeparation) std::atomic<size_t> tail_;
+
+  // Suspended async_pop() / async_push() operations
+  alignas(kSeparation) detail::AsyncWaiterStack async_consumers_;
+  detail::AsyncWaiterStack async_producers_;
 
-  alignas(kCacheLineSize) std::atomic<size_t> head_;
-  alignas(kCacheLineSize) std::atomic<size_t> tail_;
+#if defined(__cpp_lib_atomic_wait)
+  // Sleepers in pop_wait() / push_wait(). Every publish reads the waiter
+  // count, which is written only by threads about to sleep
+  EventCount not_empty_;
+  EventCount not_full_;
+#endif
 
   // Ring buffer
-  alignas(kCacheLineSize) Cell buffer_[Capacity];
+  alignas(kSeparation) detail::RingStorage<Cell, Capacity, Layout> buffer_;
 };
 
 }  // namespace mpmc_queue
@@ -0,0 +1,211 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#ifndef MPMCQUEUE_INCLUDE_MPSCQUEUE_HPP_
+#define MPMCQUEUE_INCLUDE_MPSCQUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "CacheLine.hpp"
+
+namespace mpmc_queue {
+
+/**
+ * @brief Multi-Producer Single-Consumer Lock-Free Queue
+ *
+ * Producers use the same protocol as MPMCQueue: claim a position with a CAS
+ * on head_, fill the cell and publish it through its sequence word. With a
+ * single consumer nobody competes for tail_, so the consumer just checks the
+ * sequence of the next cell and advances tail_ with a relaxed store. No
+ * read-modify-write instruction is executed on the consumer side.
+ *
+ * @tparam T The type of elements stored in the queue
+ * @tparam Capacity The maximum number of elements (must be power of 2)
+ */
+template <typename T, size_t Capacity>
+class MPSCQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of 2");
+  static_assert(Capacity > 0, "Capacity must be greater than 0");
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using reference = T&;
+  using const_reference = const T&;
+
+  /**
+   * @brief Construct a new MPSCQueue object
+   */
+  constexpr MPSCQueue() noexcept : head_(0), tail_(0) {
+    for (size_t i = 0; i < Capacity; ++i) {
+      buffer_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Destroy the MPSCQueue object
+   */
+  ~MPSCQueue() noexcept = default;
+
+  MPSCQueue(const MPSCQueue&) = delete;
+  auto operator=(const MPSCQueue&) -> MPSCQueue& = delete;
+  MPSCQueue(MPSCQueue&&) = delete;
+  auto operator=(MPSCQueue&&) -> MPSCQueue& = delete;
+
+  /**
+   * @brief Attempt to enqueue an item
+   *
+   * @param item The item to enqueue
+   * @return true if the item was successfully enqueued
+   * @return false if the queue is full
+   */
+  [[nodiscard]] auto push(const T& item) noexcept -> bool {
+    return enqueue_impl(item);
+  }
+
+  /**
+   * @brief Attempt to enqueue an item (move version)
+   *
+   * @param item The item to enqueue
+   * @return true if the item was successfully enqueued
+   * @return false if the queue is full
+   */
+  [[nodiscard]] auto push(T&& item) noexcept -> bool {
+    return enqueue_impl(std::move(item));
+  }
+
+  /**
+   * @brief Attempt to dequeue an item (consumer thread only)
+   *
+   * @param item Reference to store the dequeued item
+   * @return true if an item was successfully dequeued
+   * @return false if the queue is empty
+   */
+  [[nodiscard]] auto pop(T& item) noexcept -> bool {
+    const size_t pos = tail_.load(std::memory_order_relaxed);
+    Cell& cell = buffer_[pos & (Capacity - 1)];
+
+    if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+      return false;
+    }
+
+    item = std::move(cell.data);
+    cell.sequence.store(pos + Capacity, std::memory_order_release);
+    tail_.store(pos + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /**
+   * @brief Dequeue the run of ready items at the front (consumer thread only)
+   *
+   * Stops at the first cell that is not yet published, so items behind a
+   * producer that has claimed but not yet filled its cell stay queued.
+   *
+   * @param items Storage for the dequeued items
+   * @return size_t Number of items dequeued into the front of the span
+   */
+  [[nodiscard]] auto pop_some(std::span<T> items) noexcept -> size_t {
+    const size_t pos = tail_.load(std::memory_order_relaxed);
+    size_t count = 0;
+
+    while (count < items.size()) {
+      Cell& cell = buffer_[(pos + count) & (Capacity - 1)];
+      if (cell.sequence.load(std::memory_order_acquire) != pos + count + 1) {
+        break;
+      }
+      items[count] = std::move(cell.data);
+      cell.sequence.store(pos + count + Capacity, std::memory_order_release);
+      ++count;
+    }
+
+    if (count != 0) {
+      tail_.store(pos + count, std::memory_order_relaxed);
+    }
+    return count;
+  }
+
+  /**
+   * @brief Get the capacity of the queue
+   *
+   * @return constexpr size_t The maximum number of elements
+   */
+  [[nodiscard]] static constexpr auto max_size() noexcept -> size_t {
+    return Capacity;
+  }
+
+  /**
+   * @brief Get an approximate size of the queue
+   *
+   * Note: This is an approximation and may not be accurate in concurrent
+   * scenarios.
+   *
+   * @return size_t Approximate number of elements in the queue
+   */
+  [[nodiscard]] auto size() const noexcept -> size_t {
+    size_t head = head_.load(std::memory_order_relaxed);
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    return head >= tail ? head - tail : 0;
+  }
+
+  /**
+   * @brief Check if the queue is empty (approximate)
+   *
+   * Note: This is an approximation and may not be accurate in concurrent
+   * scenarios.
+   *
+   * @return true if the queue appears to be empty
+   * @return false if the queue appears to have elements
+   */
+  [[nodiscard]] auto empty() const noexcept -> bool { return size() == 0; }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T data;
+  };
+
+  template <typename U>
+  [[nodiscard]] auto enqueue_impl(U&& item) noexcept -> bool {
+    size_t pos;
+    Cell* cell;
+    size_t seq;
+
+    pos = head_.load(std::memory_order_relaxed);
+
+    for (;;) {
+      cell = &buffer_[pos & (Capacity - 1)];
+      seq = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          cell->data = std::forward<U>(item);
+          cell->sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  alignas(kCacheLineSize) std::atomic<size_t> head_;
+  // Written only by the consumer; atomic so that size() may read it
+  alignas(kCacheLineSize) std::atomic<size_t> tail_;
+
+  // Ring buffer
+  alignas(kCacheLineSize) Cell buffer_[Capacity];
+};
+
+}  // namespace mpmc_queue
+
+#endif  // MPMCQUEUE_INCLUDE_MPSCQUEUE_HPP_
@@ -0,0 +1,184 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#ifndef MPMCQUEUE_INCLUDE_PRIORITYMPMCQUEUE_HPP_
+#define MPMCQUEUE_INCLUDE_PRIORITYMPMCQUEUE_HPP_
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "MPMCQueue.hpp"
+
+namespace mpmc_queue {
+
+/**
+ * @brief Multi-Producer Multi-Consumer queue with priority bands
+ *
+ * One MPMCQueue ring per band. Consumers are served from the highest
+ * non-empty band first, so items pushed to a high band overtake everything
+ * waiting in lower bands. Within a band the order is FIFO; across bands
+ * there is no ordering.
+ *
+ * A bitmap with one bit per band records which bands may hold items. pop()
+ * scans only the bands whose bit is set, so empty bands cost nothing and
+ * their cache lines are not touched. A producer sets its band's bit only if
+ * the bit is clear, so in steady state pushing reads the bitmap without
+ * writing it.
+ *
+ * A consumer that finds a flagged band empty clears the bit and then checks
+ * the band again. A producer that pushed in between either sees the bit
+ * cleared and sets it again, or the consumer's re-check sees the push.
+ * Both sides use a seq_cst write followed by a seq_cst read for this.
+ *
+ * @tparam T The type of elements stored in the queue
+ * @tparam Capacity The maximum number of elements per band
+ * @tparam Bands Number of priority bands, 1 to 64; band Bands - 1 is the
+ * highest priority
+ */
+template <typename T, size_t Capacity, size_t Bands>
+class PriorityMPMCQueue {
+  static_assert(Bands > 0 && Bands <= 64, "Bands must be between 1 and 64");
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using reference = T&;
+  using const_reference = const T&;
+
+  /**
+   * @brief Construct a new PriorityMPMCQueue object
+   */
+  PriorityMPMCQueue() noexcept = default;
+
+  /**
+   * @brief Destroy the PriorityMPMCQueue object
+   */
+  ~PriorityMPMCQueue() noexcept = default;
+
+  PriorityMPMCQueue(const PriorityMPMCQueue&) = delete;
+  auto operator=(const PriorityMPMCQueue&) -> PriorityMPMCQueue& = delete;
+  PriorityMPMCQueue(PriorityMPMCQueue&&) = delete;
+  auto operator=(PriorityMPMCQueue&&) -> PriorityMPMCQueue& = delete;
+
+  /**
+   * @brief Attempt to enqueue an item into a band
+   *
+   * @param item The item to enqueue
+   * @param band Priority band, 0 (lowest) to Bands - 1 (highest)
+   * @return true if the item was successfully enqueued
+   * @return false if the band is full
+   */
+  [[nodiscard]] auto push(const T& item, size_t band) noexcept -> bool {
+    return push_impl(item, band);
+  }
+
+  /**
+   * @brief Attempt to enqueue an item into a band (move version)
+   *
+   * @param item The item to enqueue
+   * @param band Priority band, 0 (lowest) to Bands - 1 (highest)
+   * @return true if the item was successfully enqueued
+   * @return false if the band is full
+   */
+  [[nodiscard]] auto push(T&& item, size_t band) noexcept -> bool {
+    return push_impl(std::move(item), band);
+  }
+
+  /**
+   * @brief Attempt to dequeue the oldest item of the highest non-empty band
+   *
+   * @param item Reference to store the dequeued item
+   * @return true if an item was successfully dequeued
+   * @return false if every band is empty
+   */
+  [[nodiscard]] auto pop(T& item) noexcept -> bool {
+    uint64_t mask = nonempty_.load(std::memory_order_acquire);
+    while (mask != 0) {
+      const size_t band = std::bit_width(mask) - 1;
+      const uint64_t bit = uint64_t{1} << band;
+      if (bands_[band].pop(item)) {
+        return true;
+      }
+      nonempty_.fetch_and(~bit, std::memory_order_seq_cst);
+      if (!bands_[band].empty()) {
+        // A push raced with the clear; put the flag back
+        nonempty_.fetch_or(bit, std::memory_order_seq_cst);
+        if (bands_[band].pop(item)) {
+          return true;
+        }
+      }
+      mask &= ~bit;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Get the capacity of each band
+   *
+   * @return constexpr size_t The maximum number of elements per band
+   */
+  [[nodiscard]] static constexpr auto max_size() noexcept -> size_t {
+    return Capacity;
+  }
+
+  /**
+   * @brief Get the number of priority bands
+   */
+  [[nodiscard]] static constexpr auto bands() noexcept -> size_t {
+    return Bands;
+  }
+
+  /**
+   * @brief Get an approximate size of the queue, summed over all bands
+   *
+   * Note: This is an approximation and may not be accurate in concurrent
+   * scenarios.
+   *
+   * @return size_t Approximate number of elements in the queue
+   */
+  [[nodiscard]] auto size() const noexcept -> size_t {
+    size_t total = 0;
+    for (const auto& band : bands_) {
+      total += band.size();
+    }
+    return total;
+  }
+
+  /**
+   * @brief Check if the queue is empty (approximate)
+   *
+   * @return true if the queue appears to be empty
+   * @return false if the queue appears to have elements
+   */
+  [[nodiscard]] auto empty() const noexcept -> bool { return size() == 0; }
+
+ private:
+  template <typename U>
+  [[nodiscard]] auto push_impl(U&& item, size_t band) noexcept -> bool {
+    assert(band < Bands && "Priority band out of range");
+    if (!bands_[band].push(std::forward<U>(item))) {
+      return false;
+    }
+    // The push's claim CAS is seq_cst, so this load pairs with the clear
+    // and re-check in pop()
+    const uint64_t bit = uint64_t{1} << band;
+    if ((nonempty_.load(std::memory_order_seq_cst) & bit) == 0) {
+      nonempty_.fetch_or(bit, std::memory_order_seq_cst);
+    }
+    return true;
+  }
+
+  // Bit b is set if band b may hold items
+  alignas(kCacheLineSize) std::atomic<uint64_t> nonempty_{0};
+
+  MPMCQueue<T, Capacity> bands_[Bands];
+};
+
+}  // namespace mpmc_queue
+
+#endif  // MPMCQUEUE_INCLUDE_PRIORITYMPMCQUEUE_HPP_
@@ -0,0 +1,168 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#ifndef MPMCQUEUE_INCLUDE_SPSCQUEUE_HPP_
+#define MPMCQUEUE_INCLUDE_SPSCQUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include "CacheLine.hpp"
+
+namespace mpmc_queue {
+
+/**
+ * @brief Single-Producer Single-Consumer Lock-Free Queue
+ *
+ * Drop-in replacement for MPMCQueue when exactly one thread pushes and
+ * exactly one thread pops. With a single thread on each side, head_ and
+ * tail_ can be advanced with plain release stores instead of CAS, and no
+ * per-cell sequence word is needed: a slot is full iff its position lies in
+ * [tail_, head_). Each side also keeps a private copy of the other side's
+ * index and only reloads it when the copy says the queue is full (producer)
+ * or empty (consumer), so in steady state neither side touches the other's
+ * cache line.
+ *
+ * @tparam T The type of elements stored in the queue
+ * @tparam Capacity The maximum number of elements (must be power of 2)
+ */
+template <typename T, size_t Capacity>
+class SPSCQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of 2");
+  static_assert(Capacity > 0, "Capacity must be greater than 0");
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using reference = T&;
+  using const_reference = const T&;
+
+  /**
+   * @brief Construct a new SPSCQueue object
+   */
+  constexpr SPSCQueue() noexcept
+      : head_(0), cached_tail_(0), tail_(0), cached_head_(0) {}
+
+  /**
+   * @brief Destroy the SPSCQueue object
+   */
+  ~SPSCQueue() noexcept = default;
+
+  SPSCQueue(const SPSCQueue&) = delete;
+  auto operator=(const SPSCQueue&) -> SPSCQueue& = delete;
+  SPSCQueue(SPSCQueue&&) = delete;
+  auto operator=(SPSCQueue&&) -> SPSCQueue& = delete;
+
+  /**
+   * @brief Attempt to enqueue an item (producer thread only)
+   *
+   * @param item The item to enqueue
+   * @return true if the item was successfully enqueued
+   * @return false if the queue is full
+   */
+  [[nodiscard]] auto push(const T& item) noexcept -> bool {
+    return enqueue_impl(item);
+  }
+
+  /**
+   * @brief Attempt to enqueue an item (move version, producer thread only)
+   *
+   * @param item The item to enqueue
+   * @return true if the item was successfully enqueued
+   * @return false if the queue is full
+   */
+  [[nodiscard]] auto push(T&& item) noexcept -> bool {
+    return enqueue_impl(std::move(item));
+  }
+
+  /**
+   * @brief Attempt to dequeue an item (consumer thread only)
+   *
+   * @param item Reference to store the dequeued item
+   * @return true if an item was successfully dequeued
+   * @return false if the queue is empty
+   */
+  [[nodiscard]] auto pop(T& item) noexcept -> bool {
+    const size_t pos = tail_.load(std::memory_order_relaxed);
+
+    if (pos == cached_head_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (pos == cached_head_) {
+        return false;
+      }
+    }
+
+    item = std::move(buffer_[pos & (Capacity - 1)]);
+    tail_.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Get the capacity of the queue
+   *
+   * @return constexpr size_t The maximum number of elements
+   */
+  [[nodiscard]] static constexpr auto max_size() noexcept -> size_t {
+    return Capacity;
+  }
+
+  /**
+   * @brief Get an approximate size of the queue
+   *
+   * Note: This is an approximation and may not be accurate in concurrent
+   * scenarios.
+   *
+   * @return size_t Approximate number of elements in the queue
+   */
+  [[nodiscard]] auto size() const noexcept -> size_t {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t head = head_.load(std::memory_order_relaxed);
+    return head >= tail ? head - tail : 0;
+  }
+
+  /**
+   * @brief Check if the queue is empty (approximate)
+   *
+   * Note: This is an approximation and may not be accurate in concurrent
+   * scenarios.
+   *
+   * @return true if the queue appears to be empty
+   * @return false if the queue appears to have elements
+   */
+  [[nodiscard]] auto empty() const noexcept -> bool { return size() == 0; }
+
+ private:
+  template <typename U>
+  [[nodiscard]] auto enqueue_impl(U&& item) noexcept -> bool {
+    const size_t pos = head_.load(std::memory_order_relaxed);
+
+    if (pos - cached_tail_ == Capacity) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (pos - cached_tail_ == Capacity) {
+        return false;
+      }
+    }
+
+    buffer_[pos & (Capacity - 1)] = std::forward<U>(item);
+    head_.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Producer-owned line: head_ plus its last view of tail_
+  alignas(kCacheLineSize) std::atomic<size_t> head_;
+  size_t cached_tail_;
+
+  // Consumer-owned line: tail_ plus its last view of head_
+  alignas(kCacheLineSize) std::atomic<size_t> tail_;
+  size_t cached_head_;
+
+  // Ring buffer
+  alignas(kCacheLineSize) T buffer_[Capacity];
+};
+
+}  // namespace mpmc_queue
+
+#endif  // MPMCQUEUE_INCLUDE_SPSCQUEUE_HPP_
@@ -0,0 +1,596 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#ifndef MPMCQUEUE_INCLUDE_SENDER_HPP_
+#define MPMCQUEUE_INCLUDE_SENDER_HPP_
+
+#include <concepts>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "MPMCQueue.hpp"
+
+// Sender/receiver adaptors for MPMCQueue in the shape of P2300
+// (std::execution), implemented here because no standard library ships it
+// yet. The protocol is the member-function form of P2300, reduced to what
+// the queues need:
+//
+//   sender          using sender_concept = SenderTag;
+//                   using value_type = V;  (void: completes with no value)
+//                   auto connect(Receiver r) && -> operation state
+//   operation state start() noexcept; neither copyable nor movable
+//   receiver        set_value(V) noexcept (set_value() if V is void)
+//                   set_stopped() noexcept
+//
+// Senders complete with at most one value and never with an error: the
+// queue operations cannot fail, and the functions given to then() and
+// let_value() must not throw (an exception calls std::terminate). A closed
+// queue completes its senders with set_stopped().
+//
+// A Scheduler is an Executor (see AsyncWaiter.hpp) whose submit() also
+// accepts an ExecutorTask&, such as ThreadPool or InlineExecutor. The
+// senders complete through a task embedded in their operation state, so
+// neither waiting nor completing on the scheduler allocates.
+
+namespace mpmc_queue {
+
+/**
+ * @brief Marks a type as a sender, like std::execution::sender_t
+ */
+struct SenderTag {};
+
+template <typename S>
+concept Sender =
+    requires { typename std::remove_cvref_t<S>::sender_concept; } &&
+    std::same_as<typename std::remove_cvref_t<S>::sender_concept, SenderTag>;
+
+namespace detail {
+
+template <typename S>
+using SenderValue = typename std::remove_cvref_t<S>::value_type;
+
+template <typename S, typename R>
+using ConnectResult = decltype(std::declval<S>().connect(std::declval<R>()));
+
+// Result of calling F with a sender's value, or with nothing if it is void
+template <typename F, typename V>
+struct InvokeWithValue {
+  using type = std::invoke_result_t<F, V>;
+};
+
+template <typename F>
+struct InvokeWithValue<F, void> {
+  using type = std::invoke_result_t<F>;
+};
+
+template <typename F, typename V>
+using InvokeWithValueT = typename InvokeWithValue<F, V>::type;
+
+/**
+ * @brief Storage for an object created and destroyed by hand
+ *
+ * Lets an operation state create a child operation state in place once the
+ * child's inputs are known, from a prvalue, without the child having to be
+ * movable.
+ */
+template <typename T>
+class ManualLifetime {
+ public:
+  ManualLifetime() noexcept {}
+  ~ManualLifetime() {}
+
+  ManualLifetime(const ManualLifetime&) = delete;
+  auto operator=(const ManualLifetime&) -> ManualLifetime& = delete;
+
+  template <typename F>
+  auto construct_with(F&& make) -> T& {
+    return *::new (static_cast<void*>(&value_)) T(std::forward<F>(make)());
+  }
+
+  void destroy() noexcept { value_.~T(); }
+
+  [[nodiscard]] auto get() noexcept -> T& { return value_; }
+
+ private:
+  union {
+    T value_;
+  };
+};
+
+}  // namespace detail
+
+/**
+ * @brief Sender that completes at once with a stored value
+ */
+template <typename V>
+class JustSender {
+ public:
+  using sender_concept = SenderTag;
+  using value_type = V;
+
+  template <typename R>
+  class Operation {
+   public:
+    Operation(R receiver, V value)
+        : receiver_(std::move(receiver)), value_(std::move(value)) {}
+
+    Operation(const Operation&) = delete;
+    auto operator=(const Operation&) -> Operation& = delete;
+
+    void start() noexcept { receiver_.set_value(std::move(value_)); }
+
+   private:
+    R receiver_;
+    V value_;
+  };
+
+  explicit JustSender(V value) : value_(std::move(value)) {}
+
+  template <typename R>
+  [[nodiscard]] auto connect(R receiver) && -> Operation<R> {
+    return Operation<R>(std::move(receiver), std::move(value_));
+  }
+
+ private:
+  V value_;
+};
+
+/**
+ * @brief Sender that completes with the result of fn(value)
+ */
+template <typename S, typename F>
+class ThenSender {
+ public:
+  using sender_concept = SenderTag;
+  using value_type = detail::InvokeWithValueT<F, detail::SenderValue<S>>;
+
+  ThenSender(S upstream, F fn)
+      : upstream_(std::move(upstream)), fn_(std::move(fn)) {}
+
+  template <typename R>
+  [[nodiscard]] auto connect(R receiver) && {
+    return std::move(upstream_).connect(
+        Receiver<R>{std::move(receiver), std::move(fn_)});
+  }
+
+ private:
+  template <typename R>
+  struct Receiver {
+    R downstream;
+    F fn;
+
+    template <typename... Vs>
+    void set_value(Vs&&... values) noexcept {
+      if constexpr (std::is_void_v<value_type>) {
+        fn(std::forward<Vs>(values)...);
+        downstream.set_value();
+      } else {
+        downstream.set_value(fn(std::forward<Vs>(values)...));
+      }
+    }
+
+    void set_stopped() noexcept { downstream.set_stopped(); }
+  };
+
+  S upstream_;
+  F fn_;
+};
+
+/**
+ * @brief Sender that runs the sender fn(value) returns and completes with
+ * its result
+ */
+template <typename S, typename F>
+class LetValueSender {
+  using UpstreamValue = detail::SenderValue<S>;
+  using InnerSender = detail::InvokeWithValueT<F, UpstreamValue&>;
+
+ public:
+  using sender_concept = SenderTag;
+  using value_type = detail::SenderValue<InnerSender>;
+
+  template <typename R>
+  class Operation {
+   public:
+    Operation(S&& upstream, F fn, R receiver)
+        : receiver_(std::move(receiver)),
+          fn_(std::move(fn)),
+          upstream_(std::move(upstream).connect(UpstreamReceiver{this})) {}
+
+    ~Operation() {
+      if (inner_started_) {
+        inner_.destroy();
+        if constexpr (!std::is_void_v<UpstreamValue>) {
+          value_.destroy();
+        }
+      }
+    }
+
+    Operation(const Operation&) = delete;
+    auto operator=(const Operation&) -> Operation& = delete;
+
+    void start() noexcept { upstream_.start(); }
+
+   private:
+    struct UpstreamReceiver {
+      Operation* op;
+
+      template <typename... Vs>
+      void set_value(Vs&&... values) noexcept {
+        op->start_inner(std::forward<Vs>(values)...);
+      }
+
+      void set_stopped() noexcept { op->receiver_.set_stopped(); }
+    };
+
+    struct InnerReceiver {
+      Operation* op;
+
+      template <typename... Vs>
+      void set_value(Vs&&... values) noexcept {
+        op->receiver_.set_value(std::forward<Vs>(values)...);
+      }
+
+      void set_stopped() noexcept { op->receiver_.set_stopped(); }
+    };
+
+    struct Empty {};
+    using Value =
+        std::conditional_t<std::is_void_v<UpstreamValue>, Empty, UpstreamValue>;
+    using InnerOperation = detail::ConnectResult<InnerSender, InnerReceiver>;
+
+    template <typename... Vs>
+    void start_inner(Vs&&... values) noexcept {
+      // The value stays alive, and fn() sees it by reference, until the
+      // inner operation is destroyed
+      InnerOperation* inner;
+      if constexpr (std::is_void_v<UpstreamValue>) {
+        inner = &inner_.construct_with(
+            [&] { return fn_().connect(InnerReceiver{this}); });
+      } else {
+        Value& value = value_.construct_with(
+            [&] { return Value(std::forward<Vs>(values)...); });
+        inner = &inner_.construct_with(
+            [&] { return fn_(value).connect(InnerReceiver{this}); });
+      }
+      inner_started_ = true;
+      inner->start();
+    }
+
+    R receiver_;
+    F fn_;
+    detail::ConnectResult<S, UpstreamReceiver> upstream_;
+    detail::ManualLifetime<Value> value_;
+    detail::ManualLifetime<InnerOperation> inner_;
+    bool inner_started_ = false;
+  };
+
+  LetValueSender(S upstream, F fn)
+      : upstream_(std::move(upstream)), fn_(std::move(fn)) {}
+
+  template <typename R>
+  [[nodiscard]] auto connect(R receiver) && -> Operation<R> {
+    return Operation<R>(std::move(upstream_), std::move(fn_),
+                        std::move(receiver));
+  }
+
+ private:
+  S upstream_;
+  F fn_;
+};
+
+/**
+ * @brief Sender that pops an item from a queue and completes with it
+ */
+template <typename Queue, typename Scheduler>
+class PopSender {
+ public:
+  using sender_concept = SenderTag;
+  using value_type = typename Queue::value_type;
+
+  template <typename R>
+  class Operation {
+   public:
+    Operation(Queue& queue, Scheduler& scheduler, R receiver)
+        : receiver_(std::move(receiver)),
+          scheduler_(scheduler),
+          operation_(queue, item_, Resume{this}) {}
+
+    Operation(const Operation&) = delete;
+    auto operator=(const Operation&) -> Operation& = delete;
+
+    void start() noexcept {
+      if (operation_.try_now()) {
+        finish();
+      } else {
+        operation_.wait();
+      }
+    }
+
+   private:
+    // Embedded in the operation state, so completing allocates nothing
+    struct Finish final : ExecutorTask {
+      explicit Finish(Operation* op) noexcept : op(op) {}
+
+      void run() noexcept override { op->finish(); }
+
+      Operation* op;
+    };
+
+    // Runs on the thread whose push completed the pop
+    struct Resume {
+      Operation* op;
+
+      void operator()() const noexcept {
+        op->scheduler_.submit(static_cast<ExecutorTask&>(op->finish_));
+      }
+    };
+
+    void finish() noexcept {
+      if (operation_.status() == QueueStatus::kOk) {
+        receiver_.set_value(std::move(item_));
+      } else {
+        receiver_.set_stopped();
+      }
+    }
+
+    R receiver_;
+    Scheduler& scheduler_;
+    Finish finish_{this};
+    value_type item_{};
+    typename Queue::template PopOperation<Resume> operation_;
+  };
+
+  PopSender(Queue& queue, Scheduler& scheduler) noexcept
+      : queue_(&queue), scheduler_(&scheduler) {}
+
+  template <typename R>
+  [[nodiscard]] auto connect(R receiver) && -> Operation<R> {
+    return Operation<R>(*queue_, *scheduler_, std::move(receiver));
+  }
+
+ private:
+  Queue* queue_;
+  Scheduler* scheduler_;
+};
+
+/**
+ * @brief Sender that pushes the value of another sender into a queue
+ */
+template <typename Queue, typename Scheduler, typename S>
+class PushSender {
+  using Item = typename Queue::value_type;
+
+ public:
+  using sender_concept = SenderTag;
+  using value_type = void;
+
+  template <typename R>
+  class Operation {
+   public:
+    Operation(Queue& queue, Scheduler& scheduler, S&& upstream, R receiver)
+        : receiver_(std::move(receiver)),
+          queue_(queue),
+          scheduler_(scheduler),
+          upstream_(std::move(upstream).connect(UpstreamReceiver{this})) {}
+
+    ~Operation() {
+      if (push_started_) {
+        push_.destroy();
+        item_.destroy();
+      }
+    }
+
+    Operation(const Operation&) = delete;
+    auto operator=(const Operation&) -> Operation& = delete;
+
+    void start() noexcept { upstream_.start(); }
+
+   private:
+    struct UpstreamReceiver {
+      Operation* op;
+
+      template <typename V>
+      void set_value(V&& value) noexcept {
+        op->start_push(std::forward<V>(value));
+      }
+
+      void set_stopped() noexcept { op->receiver_.set_stopped(); }
+    };
+
+    // Embedded in the operation state, so completing allocates nothing
+    struct Finish final : ExecutorTask {
+      explicit Finish(Operation* op) noexcept : op(op) {}
+
+      void run() noexcept override { op->finish(); }
+
+      Operation* op;
+    };
+
+    // Runs on the thread whose pop completed the push
+    struct Resume {
+      Operation* op;
+
+      void operator()() const noexcept {
+        op->scheduler_.submit(static_cast<ExecutorTask&>(op->finish_));
+      }
+    };
+
+    using Push = typename Queue::template PushOperation<Item, Resume>;
+
+    template <typename V>
+    void start_push(V&& value) noexcept {
+      Item& item =
+          item_.construct_with([&] { return Item(std::forward<V>(value)); });
+      Push& push = push_.construct_with(
+          [&] { return Push(queue_, std::move(item), Resume{this}); });
+      push_started_ = true;
+      if (push.try_now()) {
+        finish();
+      } else {
+        push.wait();
+      }
+    }
+
+    void finish() noexcept {
+      if (push_.get().status() == QueueStatus::kOk) {
+        receiver_.set_value();
+      } else {
+        receiver_.set_stopped();
+      }
+    }
+
+    R receiver_;
+    Queue& queue_;
+    Scheduler& scheduler_;
+    Finish finish_{this};
+    detail::ConnectResult<S, UpstreamReceiver> upstream_;
+    detail::ManualLifetime<Item> item_;
+    detail::ManualLifetime<Push> push_;
+    bool push_started_ = false;
+  };
+
+  PushSender(Queue& queue, Scheduler& scheduler, S upstream)
+      : queue_(&queue),
+        scheduler_(&scheduler),
+        upstream_(std::move(upstream)) {}
+
+  template <typename R>
+  [[nodiscard]] auto connect(R receiver) && -> Operation<R> {
+    return Operation<R>(*queue_, *scheduler_, std::move(upstream_),
+                        std::move(receiver));
+  }
+
+ private:
+  Queue* queue_;
+  Scheduler* scheduler_;
+  S upstream_;
+};
+
+namespace detail {
+
+// Right-hand sides of sender | adaptor
+
+template <typename F>
+struct ThenClosure {
+  F fn;
+};
+
+template <typename F>
+struct LetValueClosure {
+  F fn;
+};
+
+template <typename Queue, typename Scheduler>
+struct PushClosure {
+  Queue* queue;
+  Scheduler* scheduler;
+};
+
+}  // namespace detail
+
+/**
+ * @brief Sender that completes with value
+ */
+template <typename V>
+[[nodiscard]] auto just(V value) -> JustSender<V> {
+  return JustSender<V>(std::move(value));
+}
+
+/**
+ * @brief Transform the value of a sender with fn
+ */
+template <Sender S, typename F>
+[[nodiscard]] auto then(S&& upstream, F fn)
+    -> ThenSender<std::remove_cvref_t<S>, F> {
+  return {std::forward<S>(upstream), std::move(fn)};
+}
+
+template <typename F>
+[[nodiscard]] auto then(F fn) -> detail::ThenClosure<F> {
+  return {std::move(fn)};
+}
+
+/**
+ * @brief Continue a sender with the sender fn(value) returns
+ *
+ * fn gets the value by lvalue reference; it stays alive until the returned
+ * sender's operation is destroyed.
+ */
+template <Sender S, typename F>
+[[nodiscard]] auto let_value(S&& upstream, F fn)
+    -> LetValueSender<std::remove_cvref_t<S>, F> {
+  return {std::forward<S>(upstream), std::move(fn)};
+}
+
+template <typename F>
+[[nodiscard]] auto let_value(F fn) -> detail::LetValueClosure<F> {
+  return {std::move(fn)};
+}
+
+/**
+ * @brief Sender that pops an item from queue and completes with it
+ *
+ * When started it pops at once if it can and then completes on the
+ * starting thread. Otherwise it waits without blocking a thread or
+ * allocating, like MPMCQueue::async_pop(), and completes on scheduler.
+ * Completes with set_stopped() if the queue is closed and drained.
+ * queue.value_type must be default-constructible.
+ *
+ * @param queue An MPMCQueue
+ * @param scheduler Where to complete after waiting
+ */
+template <typename Queue, typename Scheduler>
+[[nodiscard]] auto pop_sender(Queue& queue, Scheduler& scheduler) noexcept
+    -> PopSender<Queue, Scheduler> {
+  return {queue, scheduler};
+}
+
+/**
+ * @brief Sender that pushes the value of upstream into queue
+ *
+ * Waits for room the same way pop_sender() waits for an item, completes
+ * with no value, or with set_stopped() if the queue is closed.
+ *
+ * @param queue An MPMCQueue
+ * @param scheduler Where to complete after waiting
+ * @param upstream Sender of a value convertible to queue.value_type
+ */
+template <typename Queue, typename Scheduler, Sender S>
+[[nodiscard]] auto push_sender(Queue& queue, Scheduler& scheduler,
+                               S&& upstream)
+    -> PushSender<Queue, Scheduler, std::remove_cvref_t<S>> {
+  return {queue, scheduler, std::forward<S>(upstream)};
+}
+
+/**
+ * @brief push_sender() for use on the right of |
+ */
+template <typename Queue, typename Scheduler>
+[[nodiscard]] auto push_sender(Queue& queue, Scheduler& scheduler) noexcept
+    -> detail::PushClosure<Queue, Scheduler> {
+  return {&queue, &scheduler};
+}
+
+template <Sender S, typename F>
+[[nodiscard]] auto operator|(S&& upstream, detail::ThenClosure<F> closure) {
+  return then(std::forward<S>(upstream), std::move(closure.fn));
+}
+
+template <Sender S, typename F>
+[[nodiscard]] auto operator|(S&& upstream, detail::LetValueClosure<F> closure) {
+  return let_value(std::forward<S>(upstream), std::move(closure.fn));
+}
+
+template <Sender S, typename Queue, typename Scheduler>
+[[nodiscard]] auto operator|(S&& upstream,
+                             detail::PushClosure<Queue, Scheduler> closure) {
+  return push_sender(*closure.queue, *closure.scheduler,
+                     std::forward<S>(upstream));
+}
+
+}  // namespace mpmc_queue
+
+#endif  // MPMCQUEUE_INCLUDE_SENDER_HPP_
@@ -0,0 +1,204 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#ifndef MPMCQUEUE_INCLUDE_SHARDEDMPMCQUEUE_HPP_
+#define MPMCQUEUE_INCLUDE_SHARDEDMPMCQUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "MPMCQueue.hpp"
+
+namespace mpmc_queue {
+
+namespace detail {
+
+/**
+ * @brief Per-thread xorshift64 generator for shard selection
+ *
+ * Seeded from the address of the thread's own state, which differs
+ * between threads.
+ */
+inline auto ThreadRandom() noexcept -> uint64_t {
+  thread_local uint64_t state = 0;
+  if (state == 0) {
+    state = reinterpret_cast<uintptr_t>(&state) * 0x9E3779B97F4A7C15ULL | 1;
+  }
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Relaxed-FIFO Multi-Producer Multi-Consumer queue (MultiQueue)
+ *
+ * Shards independent MPMCQueue rings so that threads spread over Shards
+ * pairs of index cache lines instead of all contending on one. Each thread
+ * has a home shard, picked at random the first time it uses a queue of
+ * this type, and pushes there; if the home shard is full it tries the
+ * others in turn. Consumers look at two random shards and pop from the
+ * fuller one ("power of two choices"), which keeps the shards balanced
+ * without any shared state.
+ *
+ * Ordering guarantees:
+ * - Each shard is FIFO. Items one thread pushes to its home shard are
+ *   popped in the order they were pushed.
+ * - There is no order between shards. Items pushed by different threads,
+ *   or by one thread after its home shard overflowed, may be popped in any
+ *   order. In practice an item is popped after roughly no more than
+ *   O(Shards) items pushed later than it.
+ * - Every item pushed is popped exactly once.
+ * - push() fails only after finding every shard full, and pop() fails
+ *   only after finding every shard empty. Under concurrency each shard is
+ *   checked at a different moment, so the queue as a whole need not have
+ *   been full or empty at any single instant.
+ *
+ * @tparam T The type of elements stored in the queue
+ * @tparam ShardCapacity The maximum number of elements per shard
+ * @tparam Shards Number of inner rings
+ */
+template <typename T, size_t ShardCapacity, size_t Shards>
+class ShardedMPMCQueue {
+  static_assert(Shards > 0, "Shards must be greater than 0");
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using reference = T&;
+  using const_reference = const T&;
+
+  /**
+   * @brief Construct a new ShardedMPMCQueue object
+   */
+  ShardedMPMCQueue() noexcept = default;
+
+  /**
+   * @brief Destroy the ShardedMPMCQueue object
+   */
+  ~ShardedMPMCQueue() noexcept = default;
+
+  ShardedMPMCQueue(const ShardedMPMCQueue&) = delete;
+  auto operator=(const ShardedMPMCQueue&) -> ShardedMPMCQueue& = delete;
+  ShardedMPMCQueue(ShardedMPMCQueue&&) = delete;
+  auto operator=(ShardedMPMCQueue&&) -> ShardedMPMCQueue& = delete;
+
+  /**
+   * @brief Attempt to enqueue an item
+   *
+   * @param item The item to enqueue
+   * @return true if the item was successfully enqueued
+   * @return false if every shard was full
+   */
+  [[nodiscard]] auto push(const T& item) noexcept -> bool {
+    return push_impl(item);
+  }
+
+  /**
+   * @brief Attempt to enqueue an item (move version)
+   *
+   * @param item The item to enqueue
+   * @return true if the item was successfully enqueued
+   * @return false if every shard was full
+   */
+  [[nodiscard]] auto push(T&& item) noexcept -> bool {
+    return push_impl(std::move(item));
+  }
+
+  /**
+   * @brief Attempt to dequeue an item from the fuller of two random shards
+   *
+   * @param item Reference to store the dequeued item
+   * @return true if an item was successfully dequeued
+   * @return false if every shard was empty
+   */
+  [[nodiscard]] auto pop(T& item) noexcept -> bool {
+    const uint64_t random = detail::ThreadRandom();
+    size_t first = static_cast<size_t>(random % Shards);
+    size_t second = static_cast<size_t>((random >> 32) % Shards);
+    if (shards_[second].size() > shards_[first].size()) {
+      std::swap(first, second);
+    }
+    if (shards_[first].pop(item) || shards_[second].pop(item)) {
+      return true;
+    }
+    // Both looked empty; only report empty after checking every shard
+    for (size_t i = 1; i < Shards; ++i) {
+      if (shards_[(first + i) % Shards].pop(item)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Get the total capacity of all shards
+   *
+   * @return constexpr size_t The maximum number of elements
+   */
+  [[nodiscard]] static constexpr auto max_size() noexcept -> size_t {
+    return ShardCapacity * Shards;
+  }
+
+  /**
+   * @brief Get the number of shards
+   */
+  [[nodiscard]] static constexpr auto shards() noexcept -> size_t {
+    return Shards;
+  }
+
+  /**
+   * @brief Get an approximate size of the queue, summed over all shards
+   *
+   * Note: This is an approximation and may not be accurate in concurrent
+   * scenarios.
+   *
+   * @return size_t Approximate number of elements in the queue
+   */
+  [[nodiscard]] auto size() const noexcept -> size_t {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+      total += shard.size();
+    }
+    return total;
+  }
+
+  /**
+   * @brief Check if the queue is empty (approximate)
+   *
+   * @return true if the queue appears to be empty
+   * @return false if the queue appears to have elements
+   */
+  [[nodiscard]] auto empty() const noexcept -> bool { return size() == 0; }
+
+ private:
+  // The calling thread's home shard
+  static auto home_shard() noexcept -> size_t {
+    thread_local const size_t home =
+        static_cast<size_t>(detail::ThreadRandom() % Shards);
+    return home;
+  }
+
+  template <typename U>
+  [[nodiscard]] auto push_impl(U&& item) noexcept -> bool {
+    const size_t home = home_shard();
+    // push() only consumes item when it succeeds
+    for (size_t i = 0; i < Shards; ++i) {
+      if (shards_[(home + i) % Shards].push(std::forward<U>(item))) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  MPMCQueue<T, ShardCapacity> shards_[Shards];
+};
+
+}  // namespace mpmc_queue
+
+#endif  // MPMCQUEUE_INCLUDE_SHARDEDMPMCQUEUE_HPP_
@@ -0,0 +1,305 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#ifndef MPMCQUEUE_INCLUDE_THREADPOOL_HPP_
+#define MPMCQUEUE_INCLUDE_THREADPOOL_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+
+#include "EventCount.hpp"
+#include "MPMCQueue.hpp"
+#include "WorkStealingDeque.hpp"
+
+#if defined(__cpp_lib_atomic_wait)
+
+namespace mpmc_queue {
+
+namespace detail {
+
+/**
+ * @brief Heap-allocated ExecutorTask for submit(fn); frees itself once run
+ */
+template <typename F>
+class PoolTaskImpl final : public ExecutorTask {
+ public:
+  template <typename G>
+  explicit PoolTaskImpl(G&& fn) : fn_(std::forward<G>(fn)) {}
+
+  void run() noexcept override {
+    fn_();
+    delete this;
+  }
+
+ private:
+  F fn_;
+};
+
+/**
+ * @brief Queue entry: an ExecutorTask to run or a coroutine to resume
+ *
+ * Both are stored as they are, so the entry itself allocates nothing; only
+ * submit(fn) allocates, to wrap fn in a task. Tasks and coroutine frames
+ * are at least 2-byte aligned, and the low bit tells them apart.
+ */
+class PoolJob {
+ public:
+  PoolJob() noexcept = default;
+
+  explicit PoolJob(ExecutorTask* task) noexcept
+      : bits_(reinterpret_cast<uintptr_t>(task)) {}
+
+#if defined(__cpp_impl_coroutine)
+  explicit PoolJob(std::coroutine_handle<> handle) noexcept
+      : bits_(reinterpret_cast<uintptr_t>(handle.address()) | kCoroutineBit) {}
+#endif
+
+  /**
+   * @brief Run the task, or resume the coroutine
+   */
+  void run() noexcept {
+#if defined(__cpp_impl_coroutine)
+    if ((bits_ & kCoroutineBit) != 0) {
+      std::coroutine_handle<>::from_address(
+          reinterpret_cast<void*>(bits_ & ~kCoroutineBit))
+          .resume();
+      return;
+    }
+#endif
+    reinterpret_cast<ExecutorTask*>(bits_)->run();
+  }
+
+ private:
+  static constexpr uintptr_t kCoroutineBit = 1;
+
+  uintptr_t bits_ = 0;
+};
+
+}  // namespace detail
+
+/**
+ * @brief Work-stealing thread pool built from this library's queues
+ *
+ * Tasks submitted from outside the pool go to a global MPMCQueue injection
+ * queue. Tasks submitted from inside a task go to the running worker's own
+ * WorkStealingDeque, which it drains LIFO; idle workers take from the
+ * injection queue and then steal from other workers. Workers that find no
+ * work anywhere park on an EventCount and use no CPU until a submit wakes
+ * them, and a submit with no parked worker is a single load on top of the
+ * push.
+ *
+ * Submission is lock-free apart from allocating the task (operator new)
+ * in submit(fn); submit(ExecutorTask&) and resuming a coroutine through
+ * submit(std::coroutine_handle<>) allocate nothing. When the injection
+ * queue is full, submit() from outside the pool waits for room. A worker
+ * never waits: when its deque is full the task goes to the injection
+ * queue, and when that is full too the worker runs the task inside
+ * submit().
+ *
+ * Tasks must not throw: an escaping exception calls std::terminate. The
+ * destructor runs every task submitted before it, including tasks those
+ * tasks submit, and then joins the workers.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief Start a pool
+   *
+   * @param threads Number of worker threads (at least 1)
+   * @param queue_capacity Capacity of the global injection queue
+   */
+  explicit ThreadPool(size_t threads = std::thread::hardware_concurrency(),
+                      size_t queue_capacity = 4096)
+      : injection_(queue_capacity),
+        workers_(threads > 0 ? threads : 1) {
+    threads_.reserve(workers_.size());
+    for (size_t i = 0; i < workers_.size(); ++i) {
+      threads_.emplace_back([this, i] { worker_loop(i); });
+    }
+  }
+
+  /**
+   * @brief Run all submitted tasks, then stop and join the workers
+   */
+  ~ThreadPool() {
+    // Count one pseudo-task for "not stopping yet"; the workers exit once
+    // the count of unfinished tasks reaches zero.
+    finish_task();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+  ThreadPool(ThreadPool&&) = delete;
+  auto operator=(ThreadPool&&) -> ThreadPool& = delete;
+
+  /**
+   * @brief Run fn() on a worker thread
+   *
+   * @param fn Callable taking no arguments
+   */
+  template <typename F>
+  void submit(F&& fn) {
+    submit_job(detail::PoolJob(
+        new detail::PoolTaskImpl<std::decay_t<F>>(std::forward<F>(fn))));
+  }
+
+  /**
+   * @brief Run task.run() on a worker thread
+   *
+   * Unlike submit(fn) this allocates nothing: the caller owns the task and
+   * keeps it alive until it has run.
+   *
+   * @param task The task to run
+   */
+  void submit(ExecutorTask& task) { submit_job(detail::PoolJob(&task)); }
+
+#if defined(__cpp_impl_coroutine)
+  /**
+   * @brief Resume a suspended coroutine on a worker thread
+   *
+   * Unlike submit(fn) this allocates nothing: the handle itself is queued.
+   * This is the overload the MPMCQueue awaiters use when the pool is their
+   * Executor.
+   *
+   * @param handle The coroutine to resume
+   */
+  void submit(std::coroutine_handle<> handle) {
+    submit_job(detail::PoolJob(handle));
+  }
+#endif
+
+  /**
+   * @brief Get the number of worker threads
+   */
+  [[nodiscard]] auto thread_count() const noexcept -> size_t {
+    return workers_.size();
+  }
+
+ private:
+  void submit_job(detail::PoolJob job) {
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    if (current_.pool == this) {
+      // A worker must not wait for room in its own pool: if nothing else
+      // drains the queues it would wait forever, so with its deque and the
+      // injection queue both full it runs the task itself
+      if (!workers_[current_.index].deque.push(job) && !injection_.push(job)) {
+        run_job(job);
+        return;
+      }
+      // A deque push is only a release store. The fence gives it the
+      // seq_cst half of EventCount's handshake that the injection push
+      // gets from its claim, pairing with the fence in has_work().
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      idle_.notify_one();
+      return;
+    }
+    // The seq_cst claim inside the push pairs with the parking worker's
+    // re-check in has_work()
+    (void)injection_.push_wait(job);
+    idle_.notify_one();
+  }
+
+  struct alignas(kCacheLineSize) Worker {
+    WorkStealingDeque<detail::PoolJob, 256> deque;
+  };
+
+  // Identifies the pool and worker running on this thread; zero (no pool)
+  // on other threads, as thread_local storage is zero-initialized
+  struct CurrentWorker {
+    const ThreadPool* pool;
+    size_t index;
+  };
+
+  void worker_loop(size_t index) noexcept {
+    current_ = {this, index};
+    detail::PoolJob job;
+    for (;;) {
+      if (!find_job(index, job)) {
+        const auto key = idle_.prepare_wait();
+        // has_work() and the load of pending_ are seq_cst; they pair with
+        // the injection push, the fence after a deque push and
+        // finish_task()
+        if (pending_.load(std::memory_order_seq_cst) == 0) {
+          idle_.cancel_wait();
+          return;
+        }
+        if (has_work()) {
+          idle_.cancel_wait();
+          continue;
+        }
+        idle_.commit_wait(key);
+        continue;
+      }
+      run_job(job);
+    }
+  }
+
+  void run_job(detail::PoolJob job) noexcept {
+    job.run();
+    finish_task();
+  }
+
+  [[nodiscard]] auto find_job(size_t index, detail::PoolJob& job) noexcept
+      -> bool {
+    if (workers_[index].deque.pop(job) || injection_.pop(job)) {
+      return true;
+    }
+    for (size_t i = 1; i < workers_.size(); ++i) {
+      if (workers_[(index + i) % workers_.size()].deque.steal(job)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  [[nodiscard]] auto has_work() const noexcept -> bool {
+    if (!injection_.empty()) {
+      return true;
+    }
+    // The deque indices are read with relaxed loads; the fence orders them
+    // after prepare_wait() against the fence in submit()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (const auto& worker : workers_) {
+      if (!worker.deque.empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void finish_task() noexcept {
+    if (pending_.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+      // Last task done and the destructor has run: let everyone exit
+      idle_.notify_all();
+    }
+  }
+
+  inline static thread_local CurrentWorker current_;
+
+  // Submitted tasks not yet finished, plus one until the destructor runs
+  alignas(kCacheLineSize) std::atomic<size_t> pending_{1};
+  EventCount idle_;
+  MPMCQueue<detail::PoolJob, kDynamicCapacity> injection_;
+  std::vector<Worker> workers_;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace mpmc_queue
+
+#endif  // defined(__cpp_lib_atomic_wait)
+
+#endif  // MPMCQUEUE_INCLUDE_THREADPOOL_HPP_
@@ -0,0 +1,345 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#ifndef MPMCQUEUE_INCLUDE_UNBOUNDEDMPMCQUEUE_HPP_
+#define MPMCQUEUE_INCLUDE_UNBOUNDEDMPMCQUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#include "CacheLine.hpp"
+
+namespace mpmc_queue {
+
+/**
+ * @brief Unbounded Multi-Producer Multi-Consumer Lock-Free Queue
+ *
+ * A linked list of fixed-size segments. Each segment is a ring that runs
+ * the MPMCQueue cell/sequence protocol for exactly one lap: positions
+ * [0, SegmentCapacity) are handed out once, after which the segment is
+ * full for good and producers move on to the next segment. push() never
+ * fails; when the tail segment is full a new one is linked behind it.
+ *
+ * Drained segments are recycled through a free-list, so once the queue has
+ * grown to its peak working set, steady state performs no allocation.
+ * Segments are only returned to the heap when the queue is destroyed, so
+ * memory stays at the high-water mark.
+ *
+ * Memory reclamation: a thread only touches a segment while holding a
+ * reference on it, taken by incrementing the segment's reference count and
+ * then re-checking that the segment is still the queue's head or tail.
+ * Segments are never freed while linked or in the free-list, so the count
+ * can be incremented on a stale pointer without touching freed memory. The
+ * consumer that unlinks a drained segment marks it retired, and whoever
+ * drops the last reference to a retired segment recycles it.
+ *
+ * Unlike MPMCQueue this class allocates with operator new and therefore
+ * requires a hosted environment.
+ *
+ * @tparam T The type of elements stored in the queue
+ * @tparam SegmentCapacity Number of elements per segment
+ */
+template <typename T, size_t SegmentCapacity>
+class UnboundedMPMCQueue {
+  static_assert(SegmentCapacity > 0, "SegmentCapacity must be greater than 0");
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using reference = T&;
+  using const_reference = const T&;
+
+  /**
+   * @brief Construct a new UnboundedMPMCQueue object with one empty segment
+   */
+  UnboundedMPMCQueue() : head_(new Segment), tail_(head_.load()) {}
+
+  /**
+   * @brief Destroy the UnboundedMPMCQueue object and all its segments
+   */
+  ~UnboundedMPMCQueue() noexcept {
+    Segment* segment = head_.load(std::memory_order_relaxed);
+    while (segment != nullptr) {
+      Segment* next = segment->next.load(std::memory_order_relaxed);
+      delete segment;
+      segment = next;
+    }
+    segment = free_.load(std::memory_order_relaxed);
+    while (segment != nullptr) {
+      Segment* next = segment->free_next;
+      delete segment;
+      segment = next;
+    }
+  }
+
+  UnboundedMPMCQueue(const UnboundedMPMCQueue&) = delete;
+  auto operator=(const UnboundedMPMCQueue&) -> UnboundedMPMCQueue& = delete;
+  UnboundedMPMCQueue(UnboundedMPMCQueue&&) = delete;
+  auto operator=(UnboundedMPMCQueue&&) -> UnboundedMPMCQueue& = delete;
+
+  /**
+   * @brief Enqueue an item, growing the queue if needed
+   *
+   * @param item The item to enqueue
+   */
+  void push(const T& item) { enqueue_impl(item); }
+
+  /**
+   * @brief Enqueue an item, growing the queue if needed (move version)
+   *
+   * @param item The item to enqueue
+   */
+  void push(T&& item) { enqueue_impl(std::move(item)); }
+
+  /**
+   * @brief Attempt to dequeue an item
+   *
+   * @param item Reference to store the dequeued item
+   * @return true if an item was successfully dequeued
+   * @return false if the queue is empty
+   */
+  [[nodiscard]] auto pop(T& item) noexcept -> bool {
+    for (;;) {
+      Segment* segment = acquire(head_);
+      if (segment->pop(item)) {
+        release(segment);
+        return true;
+      }
+
+      // Until this segment is drained its next item comes first, and it is
+      // not published yet: report empty just like MPMCQueue does.
+      Segment* next = segment->next.load(std::memory_order_acquire);
+      if (!segment->drained() || next == nullptr) {
+        release(segment);
+        return false;
+      }
+
+      // Producers must stop seeing the segment before it can be recycled.
+      Segment* expected = segment;
+      tail_.compare_exchange_strong(expected, next, std::memory_order_acq_rel);
+      expected = segment;
+      if (head_.compare_exchange_strong(expected, next,
+                                        std::memory_order_acq_rel)) {
+        segment->refs.fetch_or(kRetired, std::memory_order_acq_rel);
+      }
+      release(segment);
+    }
+  }
+
+  /**
+   * @brief Get an approximate size of the queue
+   *
+   * Note: This is an approximation and may not be accurate in concurrent
+   * scenarios.
+   *
+   * @return size_t Approximate number of elements in the queue
+   */
+  [[nodiscard]] auto size() const noexcept -> size_t {
+    Segment* head = acquire(head_);
+    Segment* tail = acquire(tail_);
+    size_t pushed = tail->index * SegmentCapacity + tail->pushed();
+    size_t popped = head->index * SegmentCapacity + head->popped();
+    release(tail);
+    release(head);
+    return pushed >= popped ? pushed - popped : 0;
+  }
+
+  /**
+   * @brief Check if the queue is empty (approximate)
+   *
+   * Note: This is an approximation and may not be accurate in concurrent
+   * scenarios.
+   *
+   * @return true if the queue appears to be empty
+   * @return false if the queue appears to have elements
+   */
+  [[nodiscard]] auto empty() const noexcept -> bool { return size() == 0; }
+
+ private:
+  // Reference counts move in steps of kRef; the low bit marks a segment
+  // that has been unlinked and must be recycled by its last user.
+  static constexpr size_t kRetired = 1;
+  static constexpr size_t kRef = 2;
+
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T data;
+  };
+
+  /**
+   * @brief One lap of the MPMCQueue protocol plus list linkage
+   */
+  struct Segment {
+    Segment() noexcept { reset(); }
+
+    // Only called while no other thread can reach the segment
+    void reset() noexcept {
+      for (size_t i = 0; i < SegmentCapacity; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+      }
+      head.store(0, std::memory_order_relaxed);
+      tail.store(0, std::memory_order_relaxed);
+      next.store(nullptr, std::memory_order_relaxed);
+    }
+
+    template <typename U>
+    [[nodiscard]] auto push(U&& item) noexcept -> bool {
+      size_t pos = head.load(std::memory_order_relaxed);
+      while (pos < SegmentCapacity) {
+        if (head.compare_exchange_weak(pos, pos + 1,
+                                       std::memory_order_relaxed)) {
+          cells[pos].data = std::forward<U>(item);
+          cells[pos].sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      return false;
+    }
+
+    [[nodiscard]] auto pop(T& item) noexcept -> bool {
+      size_t pos = tail.load(std::memory_order_relaxed);
+      while (pos < SegmentCapacity) {
+        Cell& cell = cells[pos];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+          return false;
+        }
+        if (tail.compare_exchange_weak(pos, pos + 1,
+                                       std::memory_order_relaxed)) {
+          item = std::move(cell.data);
+          return true;
+        }
+      }
+      return false;
+    }
+
+    [[nodiscard]] auto drained() const noexcept -> bool {
+      return tail.load(std::memory_order_acquire) == SegmentCapacity;
+    }
+
+    [[nodiscard]] auto pushed() const noexcept -> size_t {
+      size_t pos = head.load(std::memory_order_relaxed);
+      return pos < SegmentCapacity ? pos : SegmentCapacity;
+    }
+
+    [[nodiscard]] auto popped() const noexcept -> size_t {
+      return tail.load(std::memory_order_relaxed);
+    }
+
+    alignas(kCacheLineSize) std::atomic<size_t> head;
+    alignas(kCacheLineSize) std::atomic<size_t> tail;
+    alignas(kCacheLineSize) std::atomic<Segment*> next;
+    std::atomic<size_t> refs{0};
+    // Position of the segment in the list, for size()
+    size_t index = 0;
+    // Link in the free-list
+    Segment* free_next = nullptr;
+    alignas(kCacheLineSize) Cell cells[SegmentCapacity];
+  };
+
+  template <typename U>
+  void enqueue_impl(U&& item) {
+    for (;;) {
+      Segment* segment = acquire(tail_);
+      if (segment->push(std::forward<U>(item))) {
+        release(segment);
+        return;
+      }
+
+      Segment* next = segment->next.load(std::memory_order_acquire);
+      if (next == nullptr) {
+        Segment* fresh = allocate();
+        fresh->index = segment->index + 1;
+        if (segment->next.compare_exchange_strong(next, fresh,
+                                                  std::memory_order_acq_rel)) {
+          next = fresh;
+        } else {
+          recycle(fresh);
+        }
+      }
+      Segment* expected = segment;
+      tail_.compare_exchange_strong(expected, next, std::memory_order_acq_rel);
+      release(segment);
+    }
+  }
+
+  /**
+   * @brief Take a reference on the segment currently stored in src
+   */
+  auto acquire(const std::atomic<Segment*>& src) const noexcept -> Segment* {
+    for (;;) {
+      Segment* segment = src.load(std::memory_order_acquire);
+      segment->refs.fetch_add(kRef, std::memory_order_acq_rel);
+      if (src.load(std::memory_order_acquire) == segment) {
+        return segment;
+      }
+      release(segment);
+    }
+  }
+
+  /**
+   * @brief Drop a reference; the last user of a retired segment recycles it
+   *
+   * Stale acquirers may bump the count of a retired segment after the last
+   * real user dropped it, so the retired bit is cleared with a CAS from
+   * "retired, no references" to make exactly one thread the recycler.
+   */
+  void release(Segment* segment) const noexcept {
+    if (segment->refs.fetch_sub(kRef, std::memory_order_acq_rel) !=
+        (kRef | kRetired)) {
+      return;
+    }
+    size_t expected = kRetired;
+    if (segment->refs.compare_exchange_strong(expected, 0,
+                                              std::memory_order_acq_rel)) {
+      recycle(segment);
+    }
+  }
+
+  /**
+   * @brief Take a segment from the free-list, or a new one from the heap
+   *
+   * The free-list is a Treiber stack. Only one thread at a time may pop,
+   * which rules out ABA on the top pointer; a producer that finds another
+   * pop in progress allocates instead of waiting.
+   */
+  auto allocate() -> Segment* {
+    if (!free_pop_busy_.test_and_set(std::memory_order_acquire)) {
+      Segment* segment = free_.load(std::memory_order_acquire);
+      while (segment != nullptr &&
+             !free_.compare_exchange_weak(segment, segment->free_next,
+                                          std::memory_order_acquire)) {
+      }
+      free_pop_busy_.clear(std::memory_order_release);
+      if (segment != nullptr) {
+        segment->reset();
+        return segment;
+      }
+    }
+    return new Segment;
+  }
+
+  void recycle(Segment* segment) const noexcept {
+    Segment* top = free_.load(std::memory_order_relaxed);
+    do {
+      segment->free_next = top;
+    } while (!free_.compare_exchange_weak(top, segment,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed));
+  }
+
+  alignas(kCacheLineSize) std::atomic<Segment*> head_;
+  alignas(kCacheLineSize) std::atomic<Segment*> tail_;
+
+  // Idle segments ready for reuse. Mutable because const readers such as
+  // size() may drop the last reference to a retired segment.
+  alignas(kCacheLineSize) mutable std::atomic<Segment*> free_{nullptr};
+  std::atomic_flag free_pop_busy_;
+};
+
+}  // namespace mpmc_queue
+
+#endif  // MPMCQUEUE_INCLUDE_UNBOUNDEDMPMCQUEUE_HPP_
@@ -0,0 +1,190 @@
+/**
+ * @copyright Copyright The MPMCQueue Contributors
+ */
+
+#ifndef MPMCQUEUE_INCLUDE_WORKSTEALINGDEQUE_HPP_
+#define MPMCQUEUE_INCLUDE_WORKSTEALINGDEQUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "CacheLine.hpp"
+
+namespace mpmc_queue {
+
+/**
+ * @brief Bounded Chase-Lev work-stealing deque
+ *
+ * One owner thread pushes and pops at the bottom (LIFO, so it works on its
+ * most recent, cache-hot tasks); any number of thief threads steal from
+ * the top (oldest tasks first). The owner's push and pop touch only
+ * bottom_ and do not contend with each other; the only CAS is between
+ * threads taking the last item, or between thieves.
+ *
+ * Based on Chase and Lev, "Dynamic Circular Work-Stealing Deque" (2005),
+ * with the C11 memory orders of Le et al., "Correct and Efficient
+ * Work-Stealing for Weak Memory Models" (2013). The fences of the latter
+ * are folded into seq_cst accesses to bottom_ and top_. The array is fixed
+ * and embedded, so there is no resizing and no allocation.
+ *
+ * A thief may read a slot while the owner is overwriting it for a later
+ * lap; the thief's CAS then fails and the value is discarded. That read is
+ * only well-defined for atomic slots, so T must be trivially copyable and
+ * lock-free as std::atomic<T>: typically a task pointer or index.
+ *
+ * @tparam T The type of elements stored in the deque
+ * @tparam Capacity The maximum number of elements (must be power of 2)
+ */
+template <typename T, size_t Capacity>
+class WorkStealingDeque {
+  static_assert((Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of 2");
+  static_assert(Capacity > 0, "Capacity must be greater than 0");
+  static_assert(std::is_trivially_copyable_v<T> &&
+                    std::atomic<T>::is_always_lock_free,
+                "T must be trivially copyable and lock-free as std::atomic");
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using reference = T&;
+  using const_reference = const T&;
+
+  /**
+   * @brief Construct a new WorkStealingDeque object
+   */
+  constexpr WorkStealingDeque() noexcept : top_(0), bottom_(0) {}
+
+  /**
+   * @brief Destroy the WorkStealingDeque object
+   */
+  ~WorkStealingDeque() noexcept = default;
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  auto operator=(const WorkStealingDeque&) -> WorkStealingDeque& = delete;
+  WorkStealingDeque(WorkStealingDeque&&) = delete;
+  auto operator=(WorkStealingDeque&&) -> WorkStealingDeque& = delete;
+
+  /**
+   * @brief Push an item at the bottom (owner thread only)
+   *
+   * @param item The item to push
+   * @return true if the item was pushed
+   * @return false if the deque is full
+   */
+  [[nodiscard]] auto push(const T& item) noexcept -> bool {
+    const ptrdiff_t bottom = bottom_.load(std::memory_order_relaxed);
+    const ptrdiff_t top = top_.load(std::memory_order_acquire);
+    if (bottom - top >= static_cast<ptrdiff_t>(Capacity)) {
+      return false;
+    }
+    buffer_[bottom & kMask].store(item, std::memory_order_relaxed);
+    // Publishes the slot to thieves that acquire bottom_
+    bottom_.store(bottom + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Pop the most recently pushed item (owner thread only)
+   *
+   * @param item Reference to store the popped item
+   * @return true if an item was popped
+   * @return false if the deque is empty, or a thief took the last item
+   */
+  [[nodiscard]] auto pop(T& item) noexcept -> bool {
+    const ptrdiff_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    // Reserve the bottom item before looking at top_; pairs with the
+    // seq_cst loads in steal()
+    bottom_.store(bottom, std::memory_order_seq_cst);
+    ptrdiff_t top = top_.load(std::memory_order_seq_cst);
+
+    // Restoring bottom_ is a release store too, so that a thief reading
+    // the restored value still sees the slots pushed before it
+    if (top > bottom) {
+      // Empty
+      bottom_.store(bottom + 1, std::memory_order_release);
+      return false;
+    }
+    const T value = buffer_[bottom & kMask].load(std::memory_order_relaxed);
+    if (top == bottom) {
+      // Last item: race thieves for it
+      const bool won = top_.compare_exchange_strong(
+          top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      bottom_.store(bottom + 1, std::memory_order_release);
+      if (!won) {
+        return false;
+      }
+    }
+    item = value;
+    return true;
+  }
+
+  /**
+   * @brief Steal the oldest item (any thread)
+   *
+   * @param item Reference to store the stolen item
+   * @return true if an item was stolen
+   * @return false if the deque is empty, or another thread won the race
+   * for the top item
+   */
+  [[nodiscard]] auto steal(T& item) noexcept -> bool {
+    ptrdiff_t top = top_.load(std::memory_order_seq_cst);
+    const ptrdiff_t bottom = bottom_.load(std::memory_order_seq_cst);
+    if (top >= bottom) {
+      return false;
+    }
+    const T value = buffer_[top & kMask].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return false;
+    }
+    item = value;
+    return true;
+  }
+
+  /**
+   * @brief Get the capacity of the deque
+   *
+   * @return constexpr size_t The maximum number of elements
+   */
+  [[nodiscard]] static constexpr auto max_size() noexcept -> size_t {
+    return Capacity;
+  }
+
+  /**
+   * @brief Get an approximate size of the deque
+   *
+   * Note: This is an approximation and may not be accurate in concurrent
+   * scenarios.
+   *
+   * @return size_t Approximate number of elements in the deque
+   */
+  [[nodiscard]] auto size() const noexcept -> size_t {
+    const ptrdiff_t bottom = bottom_.load(std::memory_order_relaxed);
+    const ptrdiff_t top = top_.load(std::memory_order_relaxed);
+    return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+  }
+
+  /**
+   * @brief Check if the deque is empty (approximate)
+   *
+   * @return true if the deque appears to be empty
+   * @return false if the deque appears to have elements
+   */
+  [[nodiscard]] auto empty() const noexcept -> bool { return size() == 0; }
+
+ private:
+  static constexpr ptrdiff_t kMask = static_cast<ptrdiff_t>(Capacity - 1);
+
+  // Advanced by thieves (and by the owner taking the last item)
+  alignas(kCacheLineSize) std::atomic<ptrdiff_t> top_;
+  // Written only by the owner
+  alignas(kCacheLineSize) std::atomic<ptrdiff_t> bottom_;
+
+  alignas(kCacheLineSize) std::atomic<T> buffer_[Capacity];
+};
+
+}  // namespace mpmc_queue
+
+#endif  // MPMCQUEUE_INCLUDE_WORKSTEALINGDEQUE_HPP_
@@ -1,8 +1,30 @@
 #include <gtest/gtest.h>
 
+#include <Backoff.hpp>
+#include <EventCount.hpp>
 #include <MPMCQueue.hpp>
+#include <MPSCQueue.hpp>
+#include <PriorityMPMCQueue.hpp>
+#include <SCQueue.hpp>
+#include <SPMCQueue.hpp>
+#include <SPSCQueue.hpp>
+#include <Sender.hpp>
+#include <ShardedMPMCQueue.hpp>
+#include <ThreadPool.hpp>
+#include <UnboundedMPMCQueue.hpp>
+#include <WorkStealingDeque.hpp>
 #include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <ctime>
+#include <exception>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 using namespace mpmc_queue;
@@ -263,3 +285,1877 @@ TEST(MPMCQueueTest, EightProducersEightConsumers) {
 
   EXPECT_EQ(consumer_sum, total_items);
 }
+
+// Counts copies and moves to show which pushes build temporaries
+struct CopyCounter {
+  static inline int copies = 0;
+
+  int a = 0;
+  int b = 0;
+
+  CopyCounter() = default;
+  CopyCounter(int a_in, int b_in) : a(a_in), b(b_in) {}
+  CopyCounter(const CopyCounter& other) : a(other.a), b(other.b) { ++copies; }
+  CopyCounter(CopyCounter&& other) noexcept : a(other.a), b(other.b) {
+    ++copies;
+  }
+  auto operator=(const CopyCounter& other) -> CopyCounter& {
+    a = other.a;
+    b = other.b;
+    ++copies;
+    return *this;
+  }
+  auto operator=(CopyCounter&& other) noexcept -> CopyCounter& {
+    a = other.a;
+    b = other.b;
+    ++copies;
+    return *this;
+  }
+};
+
+TEST(MPMCQueueTest, EmplaceConstructsInPlace) {
+  MPMCQueue<CopyCounter, 2> queue;
+  CopyCounter::copies = 0;
+  ASSERT_TRUE(queue.emplace(1, 2));
+  ASSERT_TRUE(queue.emplace());
+  EXPECT_FALSE(queue.emplace(5, 6));
+  EXPECT_EQ(CopyCounter::copies, 0);
+
+  CopyCounter val;
+  ASSERT_TRUE(queue.pop(val));
+  EXPECT_EQ(val.a, 1);
+  EXPECT_EQ(val.b, 2);
+  ASSERT_TRUE(queue.pop(val));
+  EXPECT_EQ(val.a, 0);
+
+  // push() moves the temporary into the cell
+  CopyCounter::copies = 0;
+  ASSERT_TRUE(queue.push(CopyCounter(3, 4)));
+  EXPECT_EQ(CopyCounter::copies, 1);
+}
+
+// Tracks how many instances are alive; has no default constructor
+struct LiveCounter {
+  static inline int live = 0;
+
+  int value;
+
+  explicit LiveCounter(int v) : value(v) { ++live; }
+  LiveCounter(const LiveCounter& other) : value(other.value) { ++live; }
+  LiveCounter(LiveCounter&& other) noexcept : value(other.value) { ++live; }
+  auto operator=(const LiveCounter&) -> LiveCounter& = default;
+  auto operator=(LiveCounter&&) noexcept -> LiveCounter& = default;
+  ~LiveCounter() { --live; }
+};
+
+TEST(MPMCQueueTest, StoresOnlyLiveItems) {
+  LiveCounter::live = 0;
+  {
+    // Constructing the queue constructs no T, and T needs no default
+    // constructor
+    MPMCQueue<LiveCounter, 8> queue;
+    EXPECT_EQ(LiveCounter::live, 0);
+    ASSERT_TRUE(queue.emplace(1));
+    ASSERT_TRUE(queue.push(LiveCounter(2)));
+    ASSERT_TRUE(queue.emplace(3));
+    EXPECT_EQ(LiveCounter::live, 3);
+
+    std::optional<LiveCounter> item = queue.try_pop();
+    ASSERT_TRUE(item.has_value());
+    EXPECT_EQ(item->value, 1);
+    EXPECT_EQ(LiveCounter::live, 3);
+    item.reset();
+    EXPECT_EQ(LiveCounter::live, 2);
+  }
+  // The destructor destroyed the two items still queued
+  EXPECT_EQ(LiveCounter::live, 0);
+
+  MPMCQueue<LiveCounter, 2> queue;
+  EXPECT_FALSE(queue.try_pop().has_value());
+}
+
+TEST(MPMCQueueTest, TryPopMoveOnly) {
+  MPMCQueue<std::unique_ptr<int>, 4> queue;
+  ASSERT_TRUE(queue.push(std::make_unique<int>(7)));
+  ASSERT_TRUE(queue.emplace(new int(8)));
+  auto first = queue.try_pop();
+  ASSERT_TRUE(first.has_value());
+  EXPECT_EQ(**first, 7);
+  std::unique_ptr<int> second;
+  ASSERT_TRUE(queue.pop(second));
+  EXPECT_EQ(*second, 8);
+  EXPECT_FALSE(queue.try_pop().has_value());
+}
+
+TEST(MPMCQueueTest, ConstantInitializedStaticQueue) {
+  // Zeroed cells are an empty queue, so construction is a constant
+  // expression and a static queue needs no run-time initialization
+  static constinit MPMCQueue<int, 1000> queue;
+  int val;
+  for (int lap = 0; lap < 3; ++lap) {
+    for (int i = 0; i < 1000; ++i) ASSERT_TRUE(queue.push(i));
+    EXPECT_FALSE(queue.push(-1));
+    for (int i = 0; i < 1000; ++i) {
+      ASSERT_TRUE(queue.pop(val));
+      ASSERT_EQ(val, i);
+    }
+    EXPECT_FALSE(queue.pop(val));
+  }
+}
+
+TEST(MPMCQueueTest, ReserveWritesInPlaceUntilCommit) {
+  MPMCQueue<std::string, 3> queue;
+  std::string val;
+
+  auto slot = queue.try_reserve();
+  ASSERT_TRUE(slot);
+  EXPECT_EQ(slot.size(), 1u);
+  slot.emplace("in").append(" place");
+  // Claimed but not yet published
+  EXPECT_EQ(queue.size(), 1u);
+  EXPECT_FALSE(queue.pop(val));
+  slot.commit();
+  EXPECT_FALSE(slot);
+  ASSERT_TRUE(queue.pop(val));
+  EXPECT_EQ(val, "in place");
+
+  // A reservation left uncommitted is published when it goes away
+  {
+    auto pending = queue.try_reserve();
+    ASSERT_TRUE(pending);
+    pending.emplace("dropped");
+  }
+  ASSERT_TRUE(queue.pop(val));
+  EXPECT_EQ(val, "dropped");
+}
+
+TEST(MPMCQueueTest, DroppedReservationValueInitializesMissingItems) {
+  MPMCQueue<std::string, 4> queue;
+  std::string val;
+
+  {
+    auto run = queue.try_reserve(3);
+    ASSERT_TRUE(run);
+    run.emplace("only one");
+  }
+  ASSERT_TRUE(queue.pop(val));
+  EXPECT_EQ(val, "only one");
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_TRUE(queue.pop(val));
+    EXPECT_EQ(val, "");
+  }
+  EXPECT_FALSE(queue.pop(val));
+}
+
+TEST(MPMCQueueDeathTest, ReservationContract) {
+  MPMCQueue<std::string, 4> queue;
+#if defined(NDEBUG)
+  // Release builds terminate without the assertion messages
+  const char* const past_end = "";
+  const char* const incomplete = "";
+  const char* const empty = "";
+#else
+  const char* const past_end = "emplace\\(\\) past the reserved cells";
+  const char* const incomplete = "commit\\(\\) before every emplace\\(\\)";
+  const char* const empty = "commit\\(\\) on an empty reservation";
+#endif
+
+  EXPECT_DEATH(
+      {
+        auto slot = queue.try_reserve();
+        slot.emplace("a");
+        slot.emplace("b");
+      },
+      past_end);
+  EXPECT_DEATH(
+      {
+        auto run = queue.try_reserve(2);
+        run.emplace("a");
+        run.commit();
+      },
+      incomplete);
+  EXPECT_DEATH(
+      {
+        auto slot = queue.try_reserve();
+        slot.emplace("a");
+        slot.commit();
+        slot.commit();
+      },
+      empty);
+}
+
+TEST(MPMCQueueTest, ReserveRunIsAllOrNothing) {
+  MPMCQueue<int, 5> queue;
+  int val;
+
+  for (int lap = 0; lap < 3; ++lap) {
+    auto run = queue.try_reserve(4);
+    ASSERT_TRUE(run);
+    EXPECT_EQ(run.size(), 4u);
+    EXPECT_FALSE(queue.try_reserve(2));
+    for (int i = 0; i < 4; ++i) run.emplace(i);
+    run[3] = 30;
+    run.commit();
+    ASSERT_TRUE(queue.push(4));
+    EXPECT_FALSE(queue.try_reserve());
+    for (int i : {0, 1, 2, 30, 4}) {
+      ASSERT_TRUE(queue.pop(val));
+      EXPECT_EQ(val, i);
+    }
+  }
+  EXPECT_FALSE(queue.try_reserve(0));
+  EXPECT_FALSE(queue.try_reserve(6));
+  queue.close();
+  EXPECT_FALSE(queue.try_reserve());
+}
+
+TEST(MPMCQueueTest, BulkPushPopAllOrNothing) {
+  MPMCQueue<int, 8> queue;
+  const int in[] = {1, 2, 3, 4, 5, 6};
+  int out[8] = {};
+
+  EXPECT_TRUE(queue.push_bulk(in));
+  EXPECT_FALSE(queue.push_bulk(in));  // Only 2 slots left
+  EXPECT_EQ(queue.size(), 6u);
+
+  EXPECT_FALSE(queue.pop_bulk(out));  // Only 6 items available
+  EXPECT_TRUE(queue.pop_bulk(std::span<int>(out, 4)));
+  for (int i = 0; i < 4; ++i) EXPECT_EQ(out[i], in[i]);
+
+  // The next run wraps around the end of the ring
+  EXPECT_TRUE(queue.push_bulk(in));
+  EXPECT_TRUE(queue.pop_bulk(std::span<int>(out, 8)));
+  EXPECT_EQ(out[0], 5);
+  EXPECT_EQ(out[1], 6);
+  for (int i = 0; i < 6; ++i) EXPECT_EQ(out[i + 2], in[i]);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(MPMCQueueTest, BulkPushPopBestEffort) {
+  MPMCQueue<int, 4> queue;
+  const int in[] = {1, 2, 3, 4, 5, 6};
+  int out[6] = {};
+
+  EXPECT_EQ(queue.push_some(in), 4u);
+  EXPECT_EQ(queue.push_some(in), 0u);
+  EXPECT_EQ(queue.pop_some(std::span<int>(out, 3)), 3u);
+  EXPECT_EQ(queue.push_some(std::span<const int>(in + 4, 2)), 2u);
+  EXPECT_EQ(queue.pop_some(out), 3u);
+  EXPECT_EQ(out[0], 4);
+  EXPECT_EQ(out[1], 5);
+  EXPECT_EQ(out[2], 6);
+  EXPECT_EQ(queue.pop_some(out), 0u);
+}
+
+TEST(MPMCQueueTest, BulkMultiThreadedPushPop) {
+  MPMCQueue<int, 1024> queue;
+  std::atomic<long long> sum{0};
+  const int num_batches = 2000;
+  const int batch_size = 16;
+  const int num_threads = 4;
+
+  auto producer = [&]() {
+    std::vector<int> batch(batch_size, 1);
+    for (int i = 0; i < num_batches; ++i) {
+      while (!queue.push_bulk(batch)) {
+        std::this_thread::yield();
+      }
+    }
+  };
+
+  auto consumer = [&]() {
+    std::vector<int> batch(batch_size);
+    long long remaining = static_cast<long long>(num_batches) * batch_size;
+    while (remaining > 0) {
+      size_t want = remaining < batch_size ? remaining : batch_size;
+      size_t got = queue.pop_some(std::span<int>(batch.data(), want));
+      if (got == 0) {
+        std::this_thread::yield();
+        continue;
+      }
+      for (size_t i = 0; i < got; ++i) sum += batch[i];
+      remaining -= static_cast<long long>(got);
+    }
+  };
+
+  std::vector<std::thread> producers;
+  std::vector<std::thread> consumers;
+
+  for (int i = 0; i < num_threads; ++i) {
+    producers.emplace_back(producer);
+    consumers.emplace_back(consumer);
+  }
+
+  for (auto& t : producers) t.join();
+  for (auto& t : consumers) t.join();
+
+  EXPECT_EQ(sum,
+            static_cast<long long>(num_batches) * batch_size * num_threads);
+}
+
+TEST(SPSCQueueTest, BasicPushPop) {
+  SPSCQueue<int, 4> queue;
+  int val = 0;
+
+  EXPECT_EQ(queue.max_size(), 4u);
+  EXPECT_TRUE(queue.empty());
+  EXPECT_TRUE(queue.push(1));
+  EXPECT_TRUE(queue.push(2));
+  EXPECT_TRUE(queue.push(3));
+  EXPECT_TRUE(queue.push(4));
+  EXPECT_FALSE(queue.push(5));  // Full
+  EXPECT_EQ(queue.size(), 4u);
+
+  EXPECT_TRUE(queue.pop(val));
+  EXPECT_EQ(val, 1);
+  EXPECT_TRUE(queue.push(5));
+  for (int expected = 2; expected <= 5; ++expected) {
+    EXPECT_TRUE(queue.pop(val));
+    EXPECT_EQ(val, expected);
+  }
+  EXPECT_FALSE(queue.pop(val));  // Empty
+}
+
+TEST(SPSCQueueTest, OneProducerOneConsumerKeepsOrder) {
+  SPSCQueue<int, 64> queue;
+  const int num_ops = 200000;
+  bool in_order = true;
+
+  std::thread producer([&]() {
+    for (int i = 0; i < num_ops; ++i) {
+      while (!queue.push(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::thread consumer([&]() {
+    int val;
+    for (int i = 0; i < num_ops; ++i) {
+      while (!queue.pop(val)) {
+        std::this_thread::yield();
+      }
+      in_order = in_order && val == i;
+    }
+  });
+
+  producer.join();
+  consumer.join();
+
+  EXPECT_TRUE(in_order);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(MPSCQueueTest, BasicPushPop) {
+  MPSCQueue<int, 4> queue;
+  int val = 0;
+  int out[4] = {};
+
+  EXPECT_TRUE(queue.push(1));
+  EXPECT_TRUE(queue.push(2));
+  EXPECT_TRUE(queue.push(3));
+  EXPECT_TRUE(queue.push(4));
+  EXPECT_FALSE(queue.push(5));  // Full
+
+  EXPECT_TRUE(queue.pop(val));
+  EXPECT_EQ(val, 1);
+  EXPECT_EQ(queue.pop_some(std::span<int>(out, 2)), 2u);
+  EXPECT_EQ(out[0], 2);
+  EXPECT_EQ(out[1], 3);
+  EXPECT_TRUE(queue.push(5));
+  EXPECT_EQ(queue.pop_some(out), 2u);
+  EXPECT_EQ(out[0], 4);
+  EXPECT_EQ(out[1], 5);
+  EXPECT_FALSE(queue.pop(val));  // Empty
+  EXPECT_EQ(queue.pop_some(out), 0u);
+}
+
+TEST(MPSCQueueTest, ManyProducersOneConsumer) {
+  MPSCQueue<int, 1024> queue;
+  const int num_producers = 8;
+  const int ops_per_producer = 20000;
+  long long sum = 0;
+
+  auto producer = [&]() {
+    for (int i = 0; i < ops_per_producer; ++i) {
+      while (!queue.push(1)) {
+        std::this_thread::yield();
+      }
+    }
+  };
+
+  std::vector<std::thread> producers;
+  for (int i = 0; i < num_producers; ++i) producers.emplace_back(producer);
+
+  int batch[32];
+  long long remaining =
+      static_cast<long long>(num_producers) * ops_per_producer;
+  while (remaining > 0) {
+    size_t got = queue.pop_some(batch);
+    if (got == 0) {
+      std::this_thread::yield();
+      continue;
+    }
+    for (size_t i = 0; i < got; ++i) sum += batch[i];
+    remaining -= static_cast<long long>(got);
+  }
+
+  for (auto& t : producers) t.join();
+
+  EXPECT_EQ(sum, static_cast<long long>(num_producers) * ops_per_producer);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(SPMCQueueTest, BasicPushPop) {
+  SPMCQueue<int, 4> queue;
+  int val = 0;
+
+  EXPECT_TRUE(queue.push(1));
+  EXPECT_TRUE(queue.push(2));
+  EXPECT_TRUE(queue.push(3));
+  EXPECT_TRUE(queue.push(4));
+  EXPECT_FALSE(queue.push(5));  // Full
+  EXPECT_EQ(queue.size(), 4u);
+
+  EXPECT_TRUE(queue.pop(val));
+  EXPECT_EQ(val, 1);
+  EXPECT_TRUE(queue.push(5));
+  for (int expected = 2; expected <= 5; ++expected) {
+    EXPECT_TRUE(queue.pop(val));
+    EXPECT_EQ(val, expected);
+  }
+  EXPECT_FALSE(queue.pop(val));  // Empty
+}
+
+TEST(SPMCQueueTest, OneProducerManyConsumers) {
+  SPMCQueue<int, 1024> queue;
+  std::atomic<long long> consumer_sum{0};
+  const int num_consumers = 8;
+  const int ops_per_consumer = 20000;
+
+  auto consumer = [&]() {
+    int val;
+    for (int i = 0; i < ops_per_consumer; ++i) {
+      while (!queue.pop(val)) {
+        std::this_thread::yield();
+      }
+      consumer_sum += val;
+    }
+  };
+
+  std::vector<std::thread> consumers;
+  for (int i = 0; i < num_consumers; ++i) consumers.emplace_back(consumer);
+
+  for (int i = 0; i < num_consumers * ops_per_consumer; ++i) {
+    while (!queue.push(1)) {
+      std::this_thread::yield();
+    }
+  }
+
+  for (auto& t : consumers) t.join();
+
+  EXPECT_EQ(consumer_sum, num_consumers * ops_per_consumer);
+}
+
+TEST(SCQueueTest, BasicPushPop) {
+  SCQueue<int, 4> queue;
+  int val = 0;
+
+  EXPECT_TRUE(queue.empty());
+  EXPECT_FALSE(queue.pop(val));  // Empty
+  EXPECT_TRUE(queue.push(1));
+  EXPECT_TRUE(queue.push(2));
+  EXPECT_TRUE(queue.push(3));
+  EXPECT_TRUE(queue.push(4));
+  EXPECT_FALSE(queue.push(5));  // Full
+
+  EXPECT_TRUE(queue.pop(val));
+  EXPECT_EQ(val, 1);
+  EXPECT_TRUE(queue.push(5));
+  for (int expected = 2; expected <= 5; ++expected) {
+    EXPECT_TRUE(queue.pop(val));
+    EXPECT_EQ(val, expected);
+  }
+  EXPECT_FALSE(queue.pop(val));  // Empty
+}
+
+TEST(SCQueueTest, ManyLapsKeepOrder) {
+  SCQueue<int, 8> queue;
+  int next_push = 0;
+  int next_pop = 0;
+  int val = 0;
+
+  // Alternate between filling, draining and failing on an empty queue so
+  // that ring cycles advance through every path many times over.
+  for (int round = 0; round < 2000; ++round) {
+    int burst = round % 9;
+    for (int i = 0; i < burst; ++i) {
+      EXPECT_EQ(queue.push(next_push), next_push - next_pop < 8);
+      if (next_push - next_pop < 8) ++next_push;
+    }
+    for (int i = 0; i < (round * 7) % 11; ++i) {
+      bool expect_item = next_pop < next_push;
+      ASSERT_EQ(queue.pop(val), expect_item);
+      if (expect_item) {
+        EXPECT_EQ(val, next_pop);
+        ++next_pop;
+      }
+    }
+  }
+}
+
+TEST(SCQueueTest, MultiThreadedPushPop) {
+  SCQueue<int, 256> queue;
+  std::atomic<long long> consumer_sum{0};
+  const int num_threads = 8;
+  const int ops_per_thread = 20000;
+
+  auto producer = [&]() {
+    for (int i = 0; i < ops_per_thread; ++i) {
+      while (!queue.push(1)) {
+        std::this_thread::yield();
+      }
+    }
+  };
+
+  auto consumer = [&]() {
+    int val;
+    for (int i = 0; i < ops_per_thread; ++i) {
+      while (!queue.pop(val)) {
+        std::this_thread::yield();
+      }
+      consumer_sum += val;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back(producer);
+    threads.emplace_back(consumer);
+  }
+  for (auto& t : threads) t.join();
+
+  EXPECT_EQ(consumer_sum, num_threads * ops_per_thread);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(UnboundedMPMCQueueTest, GrowsAcrossSegmentsInOrder) {
+  UnboundedMPMCQueue<int, 8> queue;
+  int val = 0;
+
+  EXPECT_TRUE(queue.empty());
+  EXPECT_FALSE(queue.pop(val));
+
+  // Several rounds so that drained segments go through the free-list and
+  // come back.
+  for (int round = 0; round < 5; ++round) {
+    for (int i = 0; i < 100; ++i) queue.push(i);
+    EXPECT_EQ(queue.size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_TRUE(queue.pop(val));
+      EXPECT_EQ(val, i);
+    }
+    EXPECT_FALSE(queue.pop(val));
+    EXPECT_TRUE(queue.empty());
+  }
+}
+
+TEST(UnboundedMPMCQueueTest, MultiThreadedPushPop) {
+  UnboundedMPMCQueue<int, 64> queue;
+  std::atomic<long long> consumer_sum{0};
+  const int num_threads = 4;
+  const int ops_per_thread = 50000;
+
+  auto producer = [&]() {
+    for (int i = 0; i < ops_per_thread; ++i) queue.push(1);
+  };
+
+  auto consumer = [&]() {
+    int val;
+    for (int i = 0; i < ops_per_thread; ++i) {
+      while (!queue.pop(val)) {
+        std::this_thread::yield();
+      }
+      consumer_sum += val;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back(producer);
+    threads.emplace_back(consumer);
+  }
+  for (auto& t : threads) t.join();
+
+  EXPECT_EQ(consumer_sum, num_threads * ops_per_thread);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(MPMCQueueTest, DynamicCapacityOverCallerStorage) {
+  MPMCQueue<int, kDynamicCapacity>::cell_type storage[8];
+  MPMCQueue<int, kDynamicCapacity> queue(storage);
+  const int in[] = {1, 2, 3, 4, 5, 6};
+  int out[6] = {};
+  int val = 0;
+
+  EXPECT_EQ(queue.max_size(), 8u);
+  EXPECT_TRUE(queue.push_bulk(in));
+  EXPECT_TRUE(queue.push(7));
+  EXPECT_TRUE(queue.push(8));
+  EXPECT_FALSE(queue.push(9));  // Full
+  EXPECT_EQ(queue.size(), 8u);
+
+  EXPECT_TRUE(queue.pop_bulk(out));
+  for (int i = 0; i < 6; ++i) EXPECT_EQ(out[i], in[i]);
+  EXPECT_TRUE(queue.pop(val));
+  EXPECT_EQ(val, 7);
+  EXPECT_TRUE(queue.pop(val));
+  EXPECT_EQ(val, 8);
+  EXPECT_FALSE(queue.pop(val));  // Empty
+}
+
+TEST(MPMCQueueTest, DynamicCapacityFromMemoryResource) {
+  std::pmr::monotonic_buffer_resource resource;
+  MPMCQueue<int, kDynamicCapacity> queue(1024, &resource);
+  std::atomic<long long> sum{0};
+  const int num_ops = 20000;
+  const int num_threads = 4;
+
+  EXPECT_EQ(queue.max_size(), 1024u);
+
+  auto producer = [&]() {
+    for (int i = 0; i < num_ops; ++i) {
+      while (!queue.push(1)) {
+        std::this_thread::yield();
+      }
+    }
+  };
+
+  auto consumer = [&]() {
+    int val;
+    for (int i = 0; i < num_ops; ++i) {
+      while (!queue.pop(val)) {
+        std::this_thread::yield();
+      }
+      sum += val;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back(producer);
+    threads.emplace_back(consumer);
+  }
+  for (auto& t : threads) t.join();
+
+  EXPECT_EQ(sum, num_ops * num_threads);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(MPMCQueueDeathTest, DynamicCapacityRejectsZero) {
+  using Queue = MPMCQueue<int, kDynamicCapacity>;
+#if defined(NDEBUG)
+  // Release builds terminate without the assertion message
+  const char* const message = "";
+#else
+  const char* const message = "Capacity must be greater than 0";
+#endif
+  std::span<Queue::cell_type> no_cells;
+  EXPECT_DEATH(Queue queue(no_cells), message);
+  EXPECT_DEATH(Queue queue(0), message);
+}
+
+TEST(MPMCQueueTest, NonPowerOfTwoCapacity) {
+  MPMCQueue<int, 6> queue;
+  int next_push = 0;
+  int next_pop = 0;
+  int val = 0;
+
+  EXPECT_EQ(queue.max_size(), 6u);
+  // Many laps with a varying fill level so that every cell is reused at
+  // every offset.
+  for (int round = 0; round < 500; ++round) {
+    while (queue.push(next_push)) ++next_push;
+    EXPECT_EQ(next_push - next_pop, 6);
+    for (int i = 0; i <= round % 6; ++i) {
+      ASSERT_TRUE(queue.pop(val));
+      EXPECT_EQ(val, next_pop++);
+    }
+  }
+}
+
+TEST(MPMCQueueTest, NonPowerOfTwoDynamicCapacity) {
+  MPMCQueue<int, kDynamicCapacity>::cell_type storage[5];
+  MPMCQueue<int, kDynamicCapacity> queue(storage);
+  const int in[] = {1, 2, 3};
+  int out[3] = {};
+
+  EXPECT_EQ(queue.max_size(), 5u);
+  for (int round = 0; round < 100; ++round) {
+    ASSERT_TRUE(queue.push_bulk(in));
+    ASSERT_TRUE(queue.pop_bulk(out));
+    for (int i = 0; i < 3; ++i) EXPECT_EQ(out[i], in[i]);
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(MPMCQueueTest, FastModuloMatchesRemainder) {
+  const uint64_t divisors[] = {1, 3, 5, 6, 7, 600000, 1000003,
+                               (uint64_t{1} << 32) + 15, UINT64_MAX - 2};
+  uint64_t x = 0x9e3779b97f4a7c15ULL;
+  for (uint64_t divisor : divisors) {
+    detail::FastModulo modulo(divisor);
+    for (int i = 0; i < 10000; ++i) {
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      ASSERT_EQ(modulo(x), x % divisor);
+      ASSERT_EQ(modulo(i), i % divisor);
+    }
+    ASSERT_EQ(modulo(UINT64_MAX), UINT64_MAX % divisor);
+  }
+}
+
+TEST(MPMCQueueTest, PaddedLayoutPutsCellsOnSeparateLines) {
+  using Padded = MPMCQueue<int, 8, PaddedLayout<128>>;
+  using Packed = MPMCQueue<int, 8, PackedLayout<128>>;
+
+  static_assert(sizeof(Padded::cell_type) == 128);
+  static_assert(alignof(Padded::cell_type) == 128);
+  static_assert(sizeof(Packed::cell_type) < 128);
+  static_assert(alignof(Packed) == 128);
+
+  MPMCQueue<int, kDynamicCapacity, PaddedLayout<>>::cell_type storage[3];
+  MPMCQueue<int, kDynamicCapacity, PaddedLayout<>> queue(storage);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(&storage[1]) -
+                reinterpret_cast<uintptr_t>(&storage[0]),
+            kCacheLineSize);
+  for (int round = 0; round < 10; ++round) {
+    EXPECT_TRUE(queue.push(round));
+    EXPECT_TRUE(queue.push(round + 1));
+    int val = 0;
+    EXPECT_TRUE(queue.pop(val));
+    EXPECT_EQ(val, round);
+    EXPECT_TRUE(queue.pop(val));
+    EXPECT_EQ(val, round + 1);
+  }
+}
+
+TEST(MPMCQueueTest, PaddedLayoutMultiThreadedPushPop) {
+  auto queue = std::make_unique<MPMCQueue<int, 64, PaddedLayout<>>>();
+  std::atomic<int> sum{0};
+  const int num_ops = 1000;
+  const int num_threads = 4;
+
+  auto producer = [&]() {
+    for (int i = 0; i < num_ops; ++i) {
+      while (!queue->push(1)) {
+        std::this_thread::yield();
+      }
+    }
+  };
+
+  auto consumer = [&]() {
+    int val;
+    for (int i = 0; i < num_ops; ++i) {
+      while (!queue->pop(val)) {
+        std::this_thread::yield();
+      }
+      sum += val;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back(producer);
+    threads.emplace_back(consumer);
+  }
+  for (auto& t : threads) t.join();
+
+  EXPECT_EQ(sum, num_ops * num_threads);
+}
+
+// Consecutive positions of a RemappedLayout ring sit on different lines
+template <typename T>
+void ExpectRemappedLinesDiffer() {
+  using Cell = typename MPMCQueue<T, 64, RemappedLayout<64>>::cell_type;
+  // Aligned to a line, as MPMCQueue aligns its ring
+  alignas(64) detail::RingStorage<Cell, 64, RemappedLayout<64>> ring;
+  const auto line = [&](size_t pos) {
+    return reinterpret_cast<uintptr_t>(&ring.cell(pos)) / 64;
+  };
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(&ring.cell(0)) % 64, 0u);
+  for (size_t pos = 0; pos < 64; ++pos) {
+    EXPECT_NE(line(pos), line(pos + 1)) << "position " << pos;
+  }
+}
+
+TEST(MPMCQueueTest, RemappedLayoutSpreadsConsecutivePositions) {
+  using Queue = MPMCQueue<int, 64, RemappedLayout<64>>;
+  static_assert(sizeof(Queue::cell_type) == 16);
+  static_assert(sizeof(Queue) == sizeof(MPMCQueue<int, 64, PackedLayout<64>>));
+
+  ExpectRemappedLinesDiffer<int>();
+  // 24 bytes packed, which does not divide the line
+  struct TwoLongs {
+    long a;
+    long b;
+  };
+  using TwoLongsQueue = MPMCQueue<TwoLongs, 64, RemappedLayout<64>>;
+  static_assert(sizeof(TwoLongsQueue::cell_type) == 32);
+  ExpectRemappedLinesDiffer<TwoLongs>();
+
+  Queue queue;
+  int next_push = 0;
+  int next_pop = 0;
+  int val = 0;
+
+  // Runs of every length across many laps, so that each position is
+  // mapped at each offset.
+  for (int round = 0; round < 500; ++round) {
+    while (queue.push(next_push)) ++next_push;
+    EXPECT_EQ(next_push - next_pop, 64);
+    for (int i = 0; i <= round % 64; ++i) {
+      ASSERT_TRUE(queue.pop(val));
+      EXPECT_EQ(val, next_pop++);
+    }
+  }
+
+  int in[40];
+  int out[40];
+  for (int i = 0; i < 40; ++i) in[i] = i;
+  while (queue.pop(val)) {
+  }
+  for (int round = 0; round < 20; ++round) {
+    ASSERT_TRUE(queue.push_bulk(in));
+    ASSERT_TRUE(queue.pop_bulk(out));
+    for (int i = 0; i < 40; ++i) EXPECT_EQ(out[i], i);
+  }
+}
+
+TEST(MPMCQueueTest, PopWaitBlocksUntilPush) {
+  MPMCQueue<int, 4> queue;
+  std::atomic<bool> popped{false};
+  int val = 0;
+
+  std::thread consumer([&]() {
+    queue.pop_wait(val);
+    popped = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(popped);
+
+  ASSERT_TRUE(queue.push(7));
+  consumer.join();
+  EXPECT_TRUE(popped);
+  EXPECT_EQ(val, 7);
+}
+
+TEST(MPMCQueueTest, PushWaitBlocksWhileFull) {
+  MPMCQueue<int, 2> queue;
+  std::atomic<bool> pushed{false};
+
+  ASSERT_TRUE(queue.push(1));
+  ASSERT_TRUE(queue.push(2));
+  std::thread producer([&]() {
+    queue.push_wait(3);
+    pushed = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(pushed);
+
+  int val = 0;
+  ASSERT_TRUE(queue.pop(val));
+  producer.join();
+  EXPECT_TRUE(pushed);
+  for (int expected : {2, 3}) {
+    ASSERT_TRUE(queue.pop(val));
+    EXPECT_EQ(val, expected);
+  }
+}
+
+TEST(MPMCQueueTest, BlockingMultiThreadedPushPop) {
+  // A small ring so that both sides sleep regularly
+  MPMCQueue<int, 4> queue;
+  std::atomic<int> sum{0};
+  const int num_ops = 5000;
+  const int num_threads = 4;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < num_ops; ++j) queue.push_wait(1);
+    });
+    threads.emplace_back([&]() {
+      int val;
+      for (int j = 0; j < num_ops; ++j) {
+        queue.pop_wait(val);
+        sum += val;
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  EXPECT_EQ(sum, num_ops * num_threads);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(EventCountTest, NotifyAfterPrepareWakesCommit) {
+  EventCount ec;
+
+  // No waiters: notify is a no-op
+  ec.notify_one();
+  ec.notify_all();
+
+  auto key = ec.prepare_wait();
+  ec.notify_one();
+  // Must return at once: the notify came after prepare_wait()
+  ec.commit_wait(key);
+
+  key = ec.prepare_wait();
+  ec.cancel_wait();
+}
+
+TEST(EventCountTest, PingPongLosesNoWakeups) {
+  // Two threads hand a token back and forth, each sleeping until it is its
+  // turn. A single lost wakeup deadlocks the test.
+  EventCount ec;
+  std::atomic<int> turn{0};
+  const int rounds = 20000;
+
+  auto player = [&](int me) {
+    for (int i = 0; i < rounds; ++i) {
+      for (;;) {
+        if (turn.load(std::memory_order_seq_cst) % 2 == me) break;
+        auto key = ec.prepare_wait();
+        if (turn.load(std::memory_order_seq_cst) % 2 == me) {
+          ec.cancel_wait();
+          break;
+        }
+        ec.commit_wait(key);
+      }
+      turn.fetch_add(1, std::memory_order_seq_cst);
+      ec.notify_one();
+    }
+  };
+
+  std::thread a(player, 0);
+  std::thread b(player, 1);
+  a.join();
+  b.join();
+  EXPECT_EQ(turn, 2 * rounds);
+}
+
+TEST(EventCountTest, NotifyAllWakesEveryWaiter) {
+  EventCount ec;
+  std::atomic<int> generation{0};
+  std::atomic<int> seen{0};
+  const int num_threads = 8;
+  const int generations = 500;
+
+  std::vector<std::thread> waiters;
+  for (int t = 0; t < num_threads; ++t) {
+    waiters.emplace_back([&]() {
+      for (int g = 1; g <= generations; ++g) {
+        for (;;) {
+          if (generation.load(std::memory_order_seq_cst) >= g) break;
+          auto key = ec.prepare_wait();
+          if (generation.load(std::memory_order_seq_cst) >= g) {
+            ec.cancel_wait();
+            break;
+          }
+          ec.commit_wait(key);
+        }
+        seen.fetch_add(1);
+      }
+    });
+  }
+
+  for (int g = 1; g <= generations; ++g) {
+    // Wait for every waiter to finish the previous generation
+    while (seen.load() < (g - 1) * num_threads) std::this_thread::yield();
+    generation.store(g, std::memory_order_seq_cst);
+    ec.notify_all();
+  }
+  for (auto& t : waiters) t.join();
+  EXPECT_EQ(seen, generations * num_threads);
+}
+
+TEST(MPMCQueueTest, TimedPopTimesOutOnEmptyQueue) {
+  MPMCQueue<int, 4> queue;
+  int val = 0;
+
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(queue.pop_for(val, std::chrono::milliseconds(5)),
+            QueueStatus::kTimeout);
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(5));
+
+  // A deadline in the past still takes an available item
+  EXPECT_EQ(queue.pop_until(val, start), QueueStatus::kTimeout);
+  ASSERT_TRUE(queue.push(3));
+  EXPECT_EQ(queue.pop_until(val, start), QueueStatus::kOk);
+  EXPECT_EQ(val, 3);
+  EXPECT_EQ(queue.pop_for(val, std::chrono::nanoseconds(0)),
+            QueueStatus::kTimeout);
+}
+
+TEST(MPMCQueueTest, TimedPushTimesOutOnFullQueue) {
+  MPMCQueue<int, 2> queue;
+  ASSERT_TRUE(queue.push(1));
+  ASSERT_TRUE(queue.push(2));
+
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(queue.push_for(3, std::chrono::milliseconds(5)),
+            QueueStatus::kTimeout);
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(5));
+  EXPECT_EQ(queue.push_until(3, std::chrono::system_clock::now()),
+            QueueStatus::kTimeout);
+  EXPECT_EQ(queue.size(), 2u);
+}
+
+TEST(MPMCQueueTest, TimedPopWakesWhenItemArrives) {
+  MPMCQueue<int, 4> queue;
+  int val = 0;
+  QueueStatus status = QueueStatus::kTimeout;
+
+  std::thread consumer(
+      [&]() { status = queue.pop_for(val, std::chrono::seconds(10)); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  const auto pushed_at = std::chrono::steady_clock::now();
+  ASSERT_TRUE(queue.push(42));
+  consumer.join();
+
+  EXPECT_EQ(status, QueueStatus::kOk);
+  EXPECT_EQ(val, 42);
+  EXPECT_LT(std::chrono::steady_clock::now() - pushed_at,
+            std::chrono::seconds(5));
+}
+
+TEST(MPMCQueueTest, BlockingPopSleepsWhileItemIsReserved) {
+  MPMCQueue<int, 4> queue;
+  int val = 0;
+  QueueStatus status = QueueStatus::kTimeout;
+  auto slot = queue.try_reserve();
+  ASSERT_TRUE(slot);
+  slot.emplace(42);
+
+  // The claimed cell must not keep the consumer spinning
+  const std::clock_t cpu_before = std::clock();
+  EXPECT_EQ(queue.pop_for(val, std::chrono::milliseconds(100)),
+            QueueStatus::kTimeout);
+  std::thread consumer([&]() { status = queue.pop_wait(val); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  const std::clock_t cpu_used = std::clock() - cpu_before;
+  slot.commit();
+  consumer.join();
+
+  EXPECT_EQ(status, QueueStatus::kOk);
+  EXPECT_EQ(val, 42);
+  EXPECT_LT(cpu_used, CLOCKS_PER_SEC / 20);
+}
+
+TEST(MPMCQueueTest, TimedMultiThreadedPushPop) {
+  MPMCQueue<int, 4> queue;
+  std::atomic<int> pushed{0};
+  std::atomic<int> popped{0};
+  const int num_ops = 2000;
+  const int num_threads = 4;
+
+  // Tight deadlines so that timeouts and successes interleave; every
+  // timeout is retried, so every item still gets through exactly once.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < num_ops; ++j) {
+        while (queue.push_for(1, std::chrono::microseconds(50)) !=
+               QueueStatus::kOk) {
+        }
+        ++pushed;
+      }
+    });
+    threads.emplace_back([&]() {
+      int val;
+      for (int j = 0; j < num_ops; ++j) {
+        while (queue.pop_for(val, std::chrono::microseconds(50)) !=
+               QueueStatus::kOk) {
+        }
+        popped += val;
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  EXPECT_EQ(pushed, num_ops * num_threads);
+  EXPECT_EQ(popped, num_ops * num_threads);
+  EXPECT_TRUE(queue.empty());
+}
+
+template <typename Backoff>
+void RunBackoffPushPop() {
+  MPMCQueue<int, 8, PackedLayout<>, Backoff> queue;
+  std::atomic<int> sum{0};
+  const int num_ops = 2000;
+  const int num_threads = 4;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < num_ops; ++j) {
+        while (!queue.push(1)) std::this_thread::yield();
+      }
+    });
+    threads.emplace_back([&]() {
+      int val;
+      for (int j = 0; j < num_ops; ++j) {
+        while (!queue.pop(val)) std::this_thread::yield();
+        sum += val;
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  EXPECT_EQ(sum, num_ops * num_threads);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(BackoffTest, EveryPolicyKeepsQueueCorrect) {
+  RunBackoffPushPop<NoBackoff>();
+  RunBackoffPushPop<PauseBackoff<>>();
+  RunBackoffPushPop<ExponentialBackoff<1, 64>>();
+  RunBackoffPushPop<SpinThenYieldBackoff<>>();
+}
+
+TEST(MPMCQueueTest, CloseDrainsThenReportsClosed) {
+  MPMCQueue<int, 4> queue;
+  ASSERT_TRUE(queue.push(1));
+  ASSERT_TRUE(queue.push(2));
+  EXPECT_FALSE(queue.is_closed());
+
+  queue.close();
+  queue.close();
+  EXPECT_TRUE(queue.is_closed());
+  EXPECT_FALSE(queue.push(3));
+  EXPECT_EQ(queue.push_wait(3), QueueStatus::kClosed);
+  EXPECT_EQ(queue.push_for(3, std::chrono::seconds(1)), QueueStatus::kClosed);
+  const int batch[] = {3, 4};
+  EXPECT_FALSE(queue.push_bulk(batch));
+  EXPECT_EQ(queue.size(), 2u);
+
+  int val = 0;
+  EXPECT_EQ(queue.pop_wait(val), QueueStatus::kOk);
+  EXPECT_EQ(val, 1);
+  ASSERT_TRUE(queue.pop(val));
+  EXPECT_EQ(val, 2);
+  EXPECT_FALSE(queue.pop(val));
+  EXPECT_EQ(queue.pop_wait(val), QueueStatus::kClosed);
+  EXPECT_EQ(queue.pop_for(val, std::chrono::seconds(1)), QueueStatus::kClosed);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(MPMCQueueTest, CloseWakesBlockedThreads) {
+  MPMCQueue<int, 2> empty_queue;
+  MPMCQueue<int, 2> full_queue;
+  ASSERT_TRUE(full_queue.push(1));
+  ASSERT_TRUE(full_queue.push(2));
+  std::atomic<int> closed{0};
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&]() {
+      int val;
+      if (empty_queue.pop_wait(val) == QueueStatus::kClosed) ++closed;
+    });
+    threads.emplace_back([&]() {
+      if (full_queue.push_wait(3) == QueueStatus::kClosed) ++closed;
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(closed, 0);
+
+  empty_queue.close();
+  full_queue.close();
+  for (auto& t : threads) t.join();
+  EXPECT_EQ(closed, 8);
+}
+
+// Clock on which every deadline has already passed. now() first runs a
+// hook, so a test can act in the window between a timed wait giving up and
+// its final retry.
+struct ExpiringClock {
+  using rep = int64_t;
+  using period = std::nano;
+  using duration = std::chrono::nanoseconds;
+  using time_point = std::chrono::time_point<ExpiringClock>;
+  static constexpr bool is_steady = true;
+
+  inline static void (*on_now)() = nullptr;
+
+  static auto now() -> time_point {
+    if (on_now != nullptr) on_now();
+    return time_point(duration(1));
+  }
+};
+
+TEST(MPMCQueueTest, TimedCallsReportCloseAfterTheirWaitExpires) {
+  static MPMCQueue<int, 2> empty_queue;
+  static MPMCQueue<int, 2> full_queue;
+  ASSERT_TRUE(full_queue.push(1));
+  ASSERT_TRUE(full_queue.push(2));
+  const ExpiringClock::time_point deadline;
+  int val;
+
+  ExpiringClock::on_now = [] { empty_queue.close(); };
+  EXPECT_EQ(empty_queue.pop_until(val, deadline), QueueStatus::kClosed);
+  ExpiringClock::on_now = [] { full_queue.close(); };
+  EXPECT_EQ(full_queue.push_until(3, deadline), QueueStatus::kClosed);
+  ExpiringClock::on_now = nullptr;
+}
+
+TEST(MPMCQueueTest, ManyConsumersRaceAgainstClose) {
+  for (int round = 0; round < 20; ++round) {
+    MPMCQueue<int, 8> queue;
+    std::atomic<long> pushed_sum{0};
+    std::atomic<long> popped_sum{0};
+    std::atomic<int> producers_done{0};
+    const int num_producers = 4;
+    const int num_consumers = 8;
+
+    // Producers push until the queue is closed under them; consumers drain
+    // until told it is closed. Every successful push must be popped exactly
+    // once and nothing may be accepted after close.
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_producers; ++i) {
+      threads.emplace_back([&, i]() {
+        for (int j = 1;; ++j) {
+          const int value = i * 1000000 + j;
+          if (queue.push_wait(value) != QueueStatus::kOk) break;
+          pushed_sum += value;
+        }
+        ++producers_done;
+      });
+    }
+    for (int i = 0; i < num_consumers; ++i) {
+      threads.emplace_back([&]() {
+        int val;
+        while (queue.pop_wait(val) == QueueStatus::kOk) popped_sum += val;
+      });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(round % 3));
+    queue.close();
+    for (auto& t : threads) t.join();
+
+    EXPECT_EQ(producers_done, num_producers);
+    EXPECT_EQ(pushed_sum, popped_sum);
+    EXPECT_TRUE(queue.empty());
+  }
+}
+
+// Coroutine that starts eagerly and frees its frame when it finishes
+struct DetachedTask {
+  struct promise_type {
+    auto get_return_object() noexcept -> DetachedTask { return {}; }
+    auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+    auto final_suspend() noexcept -> std::suspend_never { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+template <typename Queue, typename E>
+auto AsyncPopOne(Queue& queue, E& executor, int& val, QueueStatus& status)
+    -> DetachedTask {
+  status = co_await queue.async_pop(val, executor);
+}
+
+template <typename Queue, typename E>
+auto AsyncPushOne(Queue& queue, E& executor, int val, QueueStatus& status)
+    -> DetachedTask {
+  status = co_await queue.async_push(val, executor);
+}
+
+TEST(MPMCQueueTest, AsyncPopSuspendsUntilPush) {
+  MPMCQueue<int, 4> queue;
+  InlineExecutor executor;
+  int val = 0;
+  auto status = QueueStatus::kTimeout;
+
+  // Ready at once: no suspension
+  ASSERT_TRUE(queue.push(1));
+  AsyncPopOne(queue, executor, val, status);
+  EXPECT_EQ(status, QueueStatus::kOk);
+  EXPECT_EQ(val, 1);
+
+  status = QueueStatus::kTimeout;
+  AsyncPopOne(queue, executor, val, status);
+  EXPECT_EQ(status, QueueStatus::kTimeout);
+  // The push hands its item to the suspended coroutine and resumes it
+  ASSERT_TRUE(queue.push(2));
+  EXPECT_EQ(status, QueueStatus::kOk);
+  EXPECT_EQ(val, 2);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(MPMCQueueTest, AsyncPushSuspendsUntilPop) {
+  MPMCQueue<int, 2> queue;
+  InlineExecutor executor;
+  auto status = QueueStatus::kTimeout;
+  ASSERT_TRUE(queue.push(1));
+  ASSERT_TRUE(queue.push(2));
+
+  AsyncPushOne(queue, executor, 3, status);
+  EXPECT_EQ(status, QueueStatus::kTimeout);
+  int val;
+  ASSERT_TRUE(queue.pop(val));
+  EXPECT_EQ(status, QueueStatus::kOk);
+  ASSERT_TRUE(queue.pop(val));
+  ASSERT_TRUE(queue.pop(val));
+  EXPECT_EQ(val, 3);
+}
+
+TEST(MPMCQueueTest, PushReturnsWhileOwnReservationBlocksAsyncPop) {
+  MPMCQueue<int, 4> queue;
+  InlineExecutor executor;
+  int val = 0;
+  auto status = QueueStatus::kTimeout;
+  AsyncPopOne(queue, executor, val, status);
+
+  // The reserved cell is ahead of the pushed one, so the waiter cannot
+  // complete yet, and the push must not wait for this thread's commit
+  auto slot = queue.try_reserve(1);
+  ASSERT_TRUE(slot);
+  slot.emplace(4);
+  ASSERT_TRUE(queue.push(5));
+  EXPECT_EQ(status, QueueStatus::kTimeout);
+
+  // The commit serves the waiter in order
+  slot.commit();
+  EXPECT_EQ(status, QueueStatus::kOk);
+  EXPECT_EQ(val, 4);
+  ASSERT_TRUE(queue.pop(val));
+  EXPECT_EQ(val, 5);
+}
+
+TEST(MPMCQueueTest, CloseResumesSuspendedCoroutines) {
+  MPMCQueue<int, 2> empty_queue;
+  MPMCQueue<int, 2> full_queue;
+  ASSERT_TRUE(full_queue.push(1));
+  ASSERT_TRUE(full_queue.push(1));
+  InlineExecutor executor;
+  int val = 0;
+  auto pop_status = QueueStatus::kTimeout;
+  auto push_status = QueueStatus::kTimeout;
+
+  AsyncPopOne(empty_queue, executor, val, pop_status);
+  AsyncPushOne(full_queue, executor, 2, push_status);
+  EXPECT_EQ(pop_status, QueueStatus::kTimeout);
+  EXPECT_EQ(push_status, QueueStatus::kTimeout);
+
+  empty_queue.close();
+  full_queue.close();
+  EXPECT_EQ(pop_status, QueueStatus::kClosed);
+  EXPECT_EQ(push_status, QueueStatus::kClosed);
+}
+
+auto AsyncProduce(MPMCQueue<int, 4>& queue, ThreadPool& pool, int count,
+                  std::atomic<int>& done) -> DetachedTask {
+  for (int i = 1; i <= count; ++i) {
+    if (co_await queue.async_push(i, pool) != QueueStatus::kOk) break;
+  }
+  ++done;
+}
+
+auto AsyncConsume(MPMCQueue<int, 4>& queue, ThreadPool& pool,
+                  std::atomic<long>& sum, std::atomic<int>& done)
+    -> DetachedTask {
+  int val;
+  while (co_await queue.async_pop(val, pool) == QueueStatus::kOk) {
+    sum += val;
+  }
+  ++done;
+}
+
+TEST(MPMCQueueTest, AsyncProducersAndConsumersOnThreadPool) {
+  // A small queue makes both sides suspend; resumptions run on the pool
+  const int num_producers = 3;
+  const int num_consumers = 3;
+  const int count = 5000;
+  MPMCQueue<int, 4> queue;
+  std::atomic<long> sum{0};
+  std::atomic<int> producers_done{0};
+  std::atomic<int> consumers_done{0};
+  {
+    ThreadPool pool(2);
+    for (int i = 0; i < num_consumers; ++i) {
+      pool.submit([&]() { AsyncConsume(queue, pool, sum, consumers_done); });
+    }
+    for (int i = 0; i < num_producers; ++i) {
+      pool.submit([&]() { AsyncProduce(queue, pool, count, producers_done); });
+    }
+    while (producers_done != num_producers) std::this_thread::yield();
+    queue.close();
+    while (consumers_done != num_consumers) std::this_thread::yield();
+  }
+  EXPECT_EQ(sum, long{num_producers} * count * (count + 1) / 2);
+}
+
+// Receiver that records how a sender completed
+struct RecordingReceiver {
+  std::atomic<int>* value;
+  std::atomic<int>* completions;
+  std::atomic<int>* stops;
+
+  void set_value(int v) noexcept {
+    *value = v;
+    ++*completions;
+  }
+  void set_value() noexcept { ++*completions; }
+  void set_stopped() noexcept { ++*stops; }
+};
+
+TEST(SenderTest, PopSenderCompletesWhenItemPushed) {
+  MPMCQueue<int, 4> queue;
+  InlineExecutor executor;
+  std::atomic<int> value{0};
+  std::atomic<int> completions{0};
+  std::atomic<int> stops{0};
+
+  auto op = (pop_sender(queue, executor) | then([](int v) { return v * 2; }))
+                .connect(RecordingReceiver{&value, &completions, &stops});
+  op.start();
+  EXPECT_EQ(completions, 0);
+  ASSERT_TRUE(queue.push(21));
+  EXPECT_EQ(completions, 1);
+  EXPECT_EQ(value, 42);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(SenderTest, PushSenderWaitsForRoom) {
+  MPMCQueue<int, 2> queue;
+  InlineExecutor executor;
+  std::atomic<int> value{0};
+  std::atomic<int> completions{0};
+  std::atomic<int> stops{0};
+  ASSERT_TRUE(queue.push(1));
+
+  auto first = push_sender(queue, executor, just(2))
+                   .connect(RecordingReceiver{&value, &completions, &stops});
+  first.start();
+  EXPECT_EQ(completions, 1);
+
+  auto second = (just(3) | push_sender(queue, executor))
+                    .connect(RecordingReceiver{&value, &completions, &stops});
+  second.start();
+  EXPECT_EQ(completions, 1);
+  int val;
+  ASSERT_TRUE(queue.pop(val));
+  EXPECT_EQ(completions, 2);
+  ASSERT_TRUE(queue.pop(val));
+  ASSERT_TRUE(queue.pop(val));
+  EXPECT_EQ(val, 3);
+}
+
+// Accepts only tasks it does not own, and runs them when asked
+struct DeferredScheduler {
+  std::vector<ExecutorTask*> tasks;
+
+  void submit(ExecutorTask& task) { tasks.push_back(&task); }
+
+  void run_all() {
+    for (ExecutorTask* task : std::exchange(tasks, {})) task->run();
+  }
+};
+
+TEST(SenderTest, CompletesThroughTaskInOperationState) {
+  MPMCQueue<int, 2> queue;
+  DeferredScheduler scheduler;
+  std::atomic<int> value{0};
+  std::atomic<int> completions{0};
+  std::atomic<int> stops{0};
+
+  auto pop = pop_sender(queue, scheduler)
+                 .connect(RecordingReceiver{&value, &completions, &stops});
+  pop.start();
+  ASSERT_TRUE(queue.push(7));
+  ASSERT_TRUE(queue.push(8));
+  ASSERT_TRUE(queue.push(9));
+  auto push = push_sender(queue, scheduler, just(10))
+                  .connect(RecordingReceiver{&value, &completions, &stops});
+  push.start();
+  EXPECT_EQ(completions, 0);
+
+  // Both waits completed on the queue; the receivers run on the scheduler
+  int val;
+  ASSERT_TRUE(queue.pop(val));
+  EXPECT_EQ(val, 8);
+  ASSERT_EQ(scheduler.tasks.size(), 2u);
+  scheduler.run_all();
+  EXPECT_EQ(completions, 2);
+  EXPECT_EQ(value, 7);
+  ASSERT_TRUE(queue.pop(val));
+  ASSERT_TRUE(queue.pop(val));
+  EXPECT_EQ(val, 10);
+}
+
+TEST(SenderTest, LetValueChainsQueues) {
+  MPMCQueue<int, 4> in;
+  MPMCQueue<int, 4> out;
+  InlineExecutor executor;
+  std::atomic<int> value{0};
+  std::atomic<int> completions{0};
+  std::atomic<int> stops{0};
+
+  auto op = (pop_sender(in, executor) | let_value([&](int& v) {
+               return push_sender(out, executor, just(v + 1));
+             }))
+                .connect(RecordingReceiver{&value, &completions, &stops});
+  op.start();
+  ASSERT_TRUE(in.push(9));
+  EXPECT_EQ(completions, 1);
+  int val;
+  ASSERT_TRUE(out.pop(val));
+  EXPECT_EQ(val, 10);
+}
+
+TEST(SenderTest, CloseCompletesWithStopped) {
+  MPMCQueue<int, 2> queue;
+  InlineExecutor executor;
+  std::atomic<int> value{0};
+  std::atomic<int> completions{0};
+  std::atomic<int> stops{0};
+
+  auto op = (pop_sender(queue, executor) | then([](int v) { return v; }))
+                .connect(RecordingReceiver{&value, &completions, &stops});
+  op.start();
+  queue.close();
+  EXPECT_EQ(completions, 0);
+  EXPECT_EQ(stops, 1);
+
+  auto push = push_sender(queue, executor, just(1))
+                  .connect(RecordingReceiver{&value, &completions, &stops});
+  push.start();
+  EXPECT_EQ(stops, 2);
+}
+
+TEST(SenderTest, PipelineOnThreadPool) {
+  // Many pipelines wait on one queue at once; a thread feeds it and the
+  // completions run on the pool
+  const int num_ops = 200;
+  MPMCQueue<int, 8> in;
+  MPMCQueue<int, 256> out;
+  std::atomic<int> value{0};
+  std::atomic<int> completions{0};
+  std::atomic<int> stops{0};
+  {
+    ThreadPool pool(2);
+    auto make = [&]() {
+      return (pop_sender(in, pool) | then([](int v) { return v * 2; }) |
+              push_sender(out, pool))
+          .connect(RecordingReceiver{&value, &completions, &stops});
+    };
+    using Operation = decltype(make());
+    std::vector<std::unique_ptr<Operation>> ops;
+    for (int i = 0; i < num_ops; ++i) {
+      ops.emplace_back(new Operation(make()));
+      ops.back()->start();
+    }
+    std::thread producer([&]() {
+      for (int i = 1; i <= num_ops; ++i) in.push_wait(i);
+    });
+    producer.join();
+    while (completions != num_ops) std::this_thread::yield();
+  }
+  long sum = 0;
+  int val;
+  while (out.pop(val)) sum += val;
+  EXPECT_EQ(sum, long{num_ops} * (num_ops + 1));
+  EXPECT_EQ(stops, 0);
+}
+
+TEST(PriorityMPMCQueueTest, HigherBandsOvertakeLowerBands) {
+  PriorityMPMCQueue<int, 8, 3> queue;
+  int val = 0;
+
+  EXPECT_FALSE(queue.pop(val));
+  ASSERT_TRUE(queue.push(1, 0));
+  ASSERT_TRUE(queue.push(2, 0));
+  ASSERT_TRUE(queue.push(10, 1));
+  ASSERT_TRUE(queue.push(20, 2));
+  ASSERT_TRUE(queue.push(11, 1));
+  EXPECT_EQ(queue.size(), 5u);
+
+  for (int expected : {20, 10, 11, 1, 2}) {
+    ASSERT_TRUE(queue.pop(val));
+    EXPECT_EQ(val, expected);
+  }
+  EXPECT_FALSE(queue.pop(val));
+  EXPECT_TRUE(queue.empty());
+
+  // Bands fill up independently
+  for (int i = 0; i < 8; ++i) ASSERT_TRUE(queue.push(i, 1));
+  EXPECT_FALSE(queue.push(8, 1));
+  EXPECT_TRUE(queue.push(8, 2));
+}
+
+#if !defined(NDEBUG)
+TEST(PriorityMPMCQueueDeathTest, RejectsBandOutOfRange) {
+  PriorityMPMCQueue<int, 8, 3> queue;
+  EXPECT_DEATH((void)queue.push(1, 3), "Priority band out of range");
+}
+#endif
+
+TEST(PriorityMPMCQueueTest, NoItemIsStrandedByAClearedFlag) {
+  // Consumers clear a band's flag whenever they find it empty, racing with
+  // producers that only set the flag when it looks clear. A stranded item
+  // would leave the consumers spinning forever.
+  PriorityMPMCQueue<int, 4, 4> queue;
+  std::atomic<int> sum{0};
+  const int num_ops = 5000;
+  const int num_threads = 4;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < num_ops; ++j) {
+        while (!queue.push(1, (i + j) % 4)) std::this_thread::yield();
+      }
+    });
+    threads.emplace_back([&]() {
+      int val;
+      for (int j = 0; j < num_ops; ++j) {
+        while (!queue.pop(val)) std::this_thread::yield();
+        sum += val;
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  EXPECT_EQ(sum, num_ops * num_threads);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(ShardedMPMCQueueTest, EveryItemPoppedOnce) {
+  ShardedMPMCQueue<int, 4, 4> queue;
+  int val = 0;
+
+  EXPECT_EQ(queue.max_size(), 16u);
+  EXPECT_FALSE(queue.pop(val));
+
+  // A single thread overflows its home shard into all the others
+  for (int i = 0; i < 16; ++i) ASSERT_TRUE(queue.push(i));
+  EXPECT_FALSE(queue.push(16));
+  EXPECT_EQ(queue.size(), 16u);
+
+  std::vector<bool> seen(16, false);
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_TRUE(queue.pop(val));
+    ASSERT_FALSE(seen[val]);
+    seen[val] = true;
+  }
+  EXPECT_FALSE(queue.pop(val));
+
+  // One item anywhere is found even if both random picks miss it
+  ASSERT_TRUE(queue.push(42));
+  ASSERT_TRUE(queue.pop(val));
+  EXPECT_EQ(val, 42);
+}
+
+TEST(ShardedMPMCQueueTest, HomeShardKeepsSingleProducerOrder) {
+  // Without overflow one producer only uses its home shard, which is FIFO
+  ShardedMPMCQueue<int, 64, 8> queue;
+  int val = 0;
+  for (int i = 0; i < 50; ++i) ASSERT_TRUE(queue.push(i));
+  for (int i = 0; i < 50; ++i) {
+    ASSERT_TRUE(queue.pop(val));
+    EXPECT_EQ(val, i);
+  }
+}
+
+TEST(ShardedMPMCQueueTest, MultiThreadedPushPop) {
+  ShardedMPMCQueue<int, 16, 4> queue;
+  std::atomic<int> sum{0};
+  const int num_ops = 5000;
+  const int num_threads = 4;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < num_ops; ++j) {
+        while (!queue.push(1)) std::this_thread::yield();
+      }
+    });
+    threads.emplace_back([&]() {
+      int val;
+      for (int j = 0; j < num_ops; ++j) {
+        while (!queue.pop(val)) std::this_thread::yield();
+        sum += val;
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  EXPECT_EQ(sum, num_ops * num_threads);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(WorkStealingDequeTest, OwnerPopsLifoThievesStealFifo) {
+  WorkStealingDeque<int, 4> deque;
+  int val = 0;
+
+  EXPECT_FALSE(deque.pop(val));
+  EXPECT_FALSE(deque.steal(val));
+  for (int i = 0; i < 4; ++i) ASSERT_TRUE(deque.push(i));
+  EXPECT_FALSE(deque.push(4));
+  EXPECT_EQ(deque.size(), 4u);
+
+  ASSERT_TRUE(deque.pop(val));
+  EXPECT_EQ(val, 3);
+  ASSERT_TRUE(deque.steal(val));
+  EXPECT_EQ(val, 0);
+  ASSERT_TRUE(deque.steal(val));
+  EXPECT_EQ(val, 1);
+  ASSERT_TRUE(deque.pop(val));
+  EXPECT_EQ(val, 2);
+  EXPECT_FALSE(deque.pop(val));
+  EXPECT_FALSE(deque.steal(val));
+  EXPECT_TRUE(deque.empty());
+
+  // Many laps around the ring
+  for (int round = 0; round < 100; ++round) {
+    ASSERT_TRUE(deque.push(round));
+    ASSERT_TRUE(deque.push(round + 1));
+    ASSERT_TRUE(deque.steal(val));
+    EXPECT_EQ(val, round);
+    ASSERT_TRUE(deque.pop(val));
+    EXPECT_EQ(val, round + 1);
+  }
+}
+
+TEST(WorkStealingDequeTest, EveryItemTakenExactlyOnce) {
+  // The owner pushes and pops while thieves steal; small capacity so that
+  // the fight over the last item happens often.
+  WorkStealingDeque<int, 8> deque;
+  const int num_items = 50000;
+  const int num_thieves = 3;
+  std::vector<std::atomic<int>> taken(num_items);
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < num_thieves; ++i) {
+    thieves.emplace_back([&]() {
+      int val;
+      while (!done.load()) {
+        if (deque.steal(val)) ++taken[val];
+      }
+    });
+  }
+
+  int val;
+  for (int i = 0; i < num_items; ++i) {
+    while (!deque.push(i)) {
+      if (deque.pop(val)) ++taken[val];
+    }
+    if (i % 3 == 0 && deque.pop(val)) ++taken[val];
+  }
+  while (deque.pop(val)) ++taken[val];
+  done = true;
+  for (auto& t : thieves) t.join();
+
+  for (int i = 0; i < num_items; ++i) ASSERT_EQ(taken[i], 1) << i;
+}
+
+TEST(ThreadPoolTest, RunsEverySubmittedTask) {
+  const int num_tasks = 10000;
+  std::vector<std::atomic<int>> runs(num_tasks);
+  {
+    ThreadPool pool(4, 16);
+    EXPECT_EQ(pool.thread_count(), 4);
+    // Capacity 16 makes submit() wait for room
+    for (int i = 0; i < num_tasks; ++i) {
+      pool.submit([&runs, i]() { ++runs[i]; });
+    }
+  }
+  for (int i = 0; i < num_tasks; ++i) ASSERT_EQ(runs[i], 1) << i;
+}
+
+TEST(ThreadPoolTest, NestedTasksRunBeforeDestructorReturns) {
+  // Each task fans out into children through the worker-local deques,
+  // overflowing them into the injection queue, and idle workers steal.
+  std::atomic<int> count{0};
+  {
+    ThreadPool pool(4);
+    struct Spawn {
+      ThreadPool* pool;
+      std::atomic<int>* count;
+      int depth;
+      void operator()() const {
+        ++*count;
+        if (depth == 0) return;
+        for (int i = 0; i < 4; ++i) pool->submit(Spawn{pool, count, depth - 1});
+      }
+    };
+    pool.submit(Spawn{&pool, &count, 6});
+  }
+  // 1 + 4 + ... + 4^6
+  EXPECT_EQ(count, 5461);
+}
+
+TEST(ThreadPoolTest, NestedSubmitsOverflowingEveryQueueDoNotDeadlock) {
+  // A single worker fills its deque and the injection queue from inside a
+  // task; with nobody else to drain them it has to run the rest itself
+  for (const size_t queue_capacity : {size_t{4096}, size_t{64}}) {
+    std::atomic<int> count{0};
+    {
+      ThreadPool pool(1, queue_capacity);
+      pool.submit([&] {
+        for (int i = 0; i < 5000; ++i) pool.submit([&] { ++count; });
+      });
+    }
+    EXPECT_EQ(count, 5000);
+  }
+}
+
+#if defined(__cpp_impl_coroutine)
+// Moves the awaiting coroutine onto the pool through submit(handle)
+struct ResumeOnPool {
+  ThreadPool& pool;
+
+  auto await_ready() const noexcept -> bool { return false; }
+  void await_suspend(std::coroutine_handle<> handle) const {
+    pool.submit(handle);
+  }
+  void await_resume() const noexcept {}
+};
+
+auto HopOntoPool(ThreadPool& pool, std::atomic<int>& on_pool, int hops)
+    -> DetachedTask {
+  const auto caller = std::this_thread::get_id();
+  for (int i = 0; i < hops; ++i) {
+    co_await ResumeOnPool{pool};
+    if (std::this_thread::get_id() != caller) ++on_pool;
+  }
+}
+
+TEST(ThreadPoolTest, ResumesCoroutineHandles) {
+  std::atomic<int> on_pool{0};
+  {
+    ThreadPool pool(2);
+    for (int i = 0; i < 10; ++i) HopOntoPool(pool, on_pool, 100);
+  }
+  // Every hop resumes on a worker, never on the thread that started it
+  EXPECT_EQ(on_pool, 1000);
+}
+#endif
+
+TEST(ThreadPoolTest, IdleWorkersWakeForLaterTasks) {
+  ThreadPool pool(2);
+  std::atomic<int> count{0};
+  for (int round = 0; round < 20; ++round) {
+    // Let the workers park before each submit
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    pool.submit([&count]() { ++count; });
+    while (count.load() != round + 1) std::this_thread::yield();
+  }
+}